@@ -54,6 +54,19 @@ public:
         bool useGPU{true};
         bool useHugePages{false};
         int intensity{100}; // 0-100
+        std::string engine{"threaded"}; // interpreter, threaded, jit
+        int batchSize{2}; // nonces hashed in lockstep per thread (1-4); a new job is
+                          // picked up between batches, so up to this many stale hashes finish first
+        int prefetchDistance{8}; // instructions ahead a scratchpad read is prefetched (0 = off, max 64);
+                                 // dataset items are always prefetched as their program starts
+        int nonceReservedBytes{0}; // top nonce bytes the pool fixes in the job blob (nicehash, 0-3)
+        int nonceInstances{1}; // local miners splitting the remaining nonce space (1-256)
+        int nonceInstance{0}; // slice of the nonce space this miner hashes (0 to nonceInstances-1)
+        std::string memoryMode{"auto"}; // fast (full dataset), light (cache only), auto
+        std::string datasetCacheDir{""}; // empty = regenerate the dataset on every start
+        bool numa{true}; // dataset replica per NUMA node, threads pinned to their node
+        bool autoTune{true}; // threads == 0: pick thread count and CPUs from the cache topology
+        std::string tuningFile{"thread_tuning.json"}; // stored tuning result (empty = calibrate every start)
     };
     
     struct PoolConfig {
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Instruction-set features of the host, detected once from CPUID (x86-64) or
+ * the auxiliary vector (arm64)
+ * Hot kernels are compiled for several ISA levels in the same binary; each
+ * module picks its variant from these flags at startup. Wider vector state only
+ * counts as available when XCR0 shows the OS saves it.
+ */
+
+struct CpuFeatureSet {
+    bool sse2;
+    bool ssse3;
+    bool sse41;
+    bool avx;
+    bool avx2;
+    bool bmi2;
+    bool avx512f;
+    bool avx512dq;
+    bool avx512bw;
+    bool aes;       // AES-NI on x86-64, the AES extension on arm64
+    bool vaes;      // VAES with AVX-512 state enabled
+    bool neon;
+    
+    CpuFeatureSet()
+        : sse2(false), ssse3(false), sse41(false), avx(false), avx2(false), bmi2(false), avx512f(false),
+          avx512dq(false), avx512bw(false), aes(false), vaes(false), neon(false) {}
+};
+
+// Highest level whose instructions the host supports (x86-64-v2/v3/v4, or NEON)
+enum class CpuIsaLevel {
+    GENERIC,
+    SSE41,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+class CpuFeatures {
+public:
+    static const CpuFeatureSet& detect();
+    static CpuIsaLevel isaLevel();
+    static std::string isaLevelToString(CpuIsaLevel level);
+    
+    // Detected features as a space-separated list, e.g. "sse2 ssse3 sse4.1 avx2 aes"
+    static std::string featureString();
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * CPU and memory topology probe for thread placement
+ * Reads NUMA nodes from /sys/devices/system/node and cores and caches from
+ * /sys/devices/system/cpu on Linux. Other platforms report a single node and
+ * one core per hardware thread, with cache sizes from sysctl on macOS.
+ */
+
+struct NumaNode {
+    int id;                 // kernel node number
+    std::vector<int> cpus;  // logical CPUs local to the node
+    size_t memoryBytes;     // node MemTotal (0 if unknown)
+    
+    NumaNode() : id(0), memoryBytes(0) {}
+};
+
+// Physical core and its SMT siblings
+struct CpuCore {
+    int package;               // physical_package_id
+    int id;                    // core_id within the package
+    std::vector<int> threads;  // logical CPUs, lowest first
+    
+    CpuCore() : package(0), id(0) {}
+};
+
+// One data or unified cache instance and the logical CPUs sharing it
+struct CpuCache {
+    int level;
+    size_t sizeBytes;
+    std::vector<int> cpus;
+    
+    CpuCache() : level(0), sizeBytes(0) {}
+};
+
+class CpuTopology {
+public:
+    // NUMA nodes that own at least one CPU, ordered by node id
+    static std::vector<NumaNode> detectNumaNodes();
+    
+    // Physical cores ordered by package and core id
+    static std::vector<CpuCore> detectCores();
+    
+    // Distinct caches of one level (2 or 3), ordered by their first CPU
+    static std::vector<CpuCache> detectCaches(int level);
+    
+    // Parse a sysfs CPU list such as "0-3,8-11", and the reverse
+    static std::vector<int> parseCpuList(const std::string& list);
+    static std::string formatCpuList(const std::vector<int>& cpus);
+    
+    // Restrict the calling thread to the given CPUs (false if unsupported or rejected)
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+};
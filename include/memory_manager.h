@@ -1,5 +1,6 @@
 #pragma once
 
+#include "randomx.h"
 #include <vector>
 #include <memory>
 #include <atomic>
@@ -23,22 +24,16 @@
 #define NEON_AVAILABLE 0
 #endif
 
-// RandomX memory requirements
+// RandomX memory requirements (RANDOMX_CACHE_SIZE and MemoryMode come from randomx.h)
 constexpr size_t RANDOMX_FAST_MEMORY = 2080ULL * 1024 * 1024;  // 2080 MiB
 constexpr size_t RANDOMX_LIGHT_MEMORY = 256ULL * 1024 * 1024;   // 256 MiB
-constexpr size_t RANDOMX_CACHE_SIZE = 64ULL * 1024 * 1024;      // 64 MiB
+static_assert(RANDOMX_LIGHT_MEMORY == RANDOMX_CACHE_SIZE, "light mode keeps only the RandomX cache");
 
 // Apple Silicon specific constants
 constexpr size_t APPLE_SILICON_CACHE_LINE = 128;  // Apple Silicon cache line size
 constexpr size_t APPLE_SILICON_PAGE_SIZE = 16384; // 16KB pages on Apple Silicon
 constexpr size_t NEON_VECTOR_SIZE = 16;           // 128-bit NEON vectors
 
-enum class MemoryMode {
-    FAST,   // 2080 MiB - maximum performance
-    LIGHT,  // 256 MiB - reduced memory usage
-    AUTO    // Automatically determine based on available resources
-};
-
 enum class InstanceType {
     SINGLE,     // Single instance
     MULTI,      // Multiple instances
@@ -275,6 +270,7 @@ namespace MemoryUtils {
     // System resource detection
     size_t getTotalMemory();
     size_t getAvailableMemory();
+    size_t getProcessResidentMemory();
     size_t getCPUCount();
     size_t getPageSize();
     
@@ -3,24 +3,46 @@
 #include "config_manager.h"
 #include "logger.h"
 #include "performance_monitor.h"
+#include "nonce_allocator.h"
+#include "share_queue.h"
 #include <string>
 #include <vector>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <cstdint>
+#include <chrono>
+#include <array>
+#include <memory>
+#include <unordered_map>
 
 // Forward declaration for RandomX
 class RandomX;
 
+constexpr size_t MINING_MAX_BLOB_SIZE = 128;  // Monero hashing blobs are 76 bytes
+constexpr size_t MINING_NONCE_OFFSET = 39;    // 4-byte little-endian nonce in the hashing blob
+constexpr uint32_t MINING_FIRST_SUBMIT_ID = 4; // JSON-RPC ids 1-3 belong to login, subscribe and authorize
+constexpr int MINING_RECEIVE_POLL_MS = 1000;   // longest a quiet socket keeps the communication thread asleep
+
 struct MiningJob {
     std::string jobId;
     std::string blob;
     std::string target;
-    uint32_t nonce;
+    std::string seedHash;  // RandomX key for this job (empty if the pool does not send one)
+    std::string algo;      // RandomX variant (rx/0, rx/wow, rx/arq): the job's algo or the configured one
+    std::shared_ptr<NonceAllocator> nonces;  // one per received job, shared by every copy of it
     bool isValid;
+    uint64_t generation;  // set when the job is published; increases with every new job
+    std::chrono::steady_clock::time_point received;  // when the notify arrived
+    
+    // Decoded once by Miner::decodeJob(): the hashing blob, where its nonce goes,
+    // and the share target as a bound on the hash's last 8 bytes read little-endian
+    alignas(64) std::array<uint8_t, MINING_MAX_BLOB_SIZE> blobBytes;
+    size_t blobSize;
+    size_t nonceOffset;
+    uint64_t target64;
     
-    MiningJob() : nonce(0), isValid(false) {}
+    MiningJob() : isValid(false), generation(0), blobBytes{}, blobSize(0), nonceOffset(MINING_NONCE_OFFSET), target64(0) {}
 };
 
 class Miner {
@@ -43,10 +65,16 @@ public:
     
     // Check if miner is initialized
     bool isInitialized() const { return m_initialized; }
+    
+    // Fill the binary fields of a job from its hex blob and target. The target may be
+    // the 4-byte compact form, 8 bytes, or a full 32-byte little-endian value.
+    static bool decodeJob(MiningJob& job);
+    static bool meetsTarget(const uint8_t* hash, uint64_t target64);
 
 private:
     // RandomX initialization
     bool initializeRandomX();
+    void tuneThreads();
     
     // Pool connection
     bool connectToPool();
@@ -55,19 +83,56 @@ private:
     bool setupSSL();
     bool sendLogin();
     bool sendData(const std::string& data);
+    bool sendDataLocked(const std::string& data);  // caller holds m_sendMutex
     bool receiveData(std::string& data);
     
     // Mining
     void miningLoop(int threadId);
-    void mineJob(int threadId);
-    bool isValidShare(const uint8_t* hash, const std::string& target);
-    void submitShare(uint32_t nonce, const uint8_t* hash);
+    // Per-thread hashing state: the job snapshot being mined and its generation,
+    // one blob copy per batch lane (rebuilt when the job changes), the nonce chunk
+    // being worked through and the thread's own hash rate
+    struct MiningLanes {
+        const MiningJob* job = nullptr;
+        uint64_t generation = 0;
+        std::vector<uint8_t> blobs;
+        std::vector<uint8_t> hashes;
+        NonceRange range;
+        double hashRate = 0.0;
+        bool exhausted = false;
+    };
+    void mineJob(int threadId, int workerId, MiningLanes& lanes);
+    bool isValidShare(const uint8_t* hash, uint64_t target64);
+    void submitShare(const MiningJob& job, uint32_t nonce, const uint8_t* hash);
+    bool dropStaleShare(uint64_t jobGeneration, uint32_t nonce);
+    
+    // Share submission thread and response matching
+    struct PendingShare {
+        uint32_t nonce;
+        std::string jobId;
+        std::chrono::steady_clock::time_point sentAt;
+    };
+    void submitLoop();
+    bool sendShare(const FoundShare& share);
+    bool completeShare(const std::string& response);
+    void expirePendingShares(bool all);
+    static bool extractJsonId(const std::string& json, uint64_t& id);
+    
+    // Job publication
+    void publishJob(const MiningJob& job);
+    void adoptJob(int threadId, MiningLanes& lanes);
+    void reclaimJobs();
     
     // Communication
     void communicationLoop();
     void processPoolMessage(const std::string& message);
     std::string extractJsonValue(const std::string& json, const std::string& key);
     
+    // Seed hash (RandomX key) changes
+    void seedLoop();
+    bool updateSeed(const MiningJob& job, const std::string& nextSeedHash);
+    void startSeedBuild(const std::string& seedHash, const std::string& algo);
+    void activateNextSeed();
+    
     // Idle detection
     void idleLoop();
     bool checkSystemIdle();
@@ -86,12 +151,54 @@ private:
     std::atomic<bool> m_running;
     std::atomic<bool> m_connected;
     std::atomic<bool> m_initialized;
-    MiningJob m_currentJob;
+    
+    // Job publication: a published job is never modified. Publishers swap m_job under
+    // m_publishMutex and then bump m_jobGeneration; mining threads compare the
+    // generation between batches and reload m_job only when it moved. Each mining
+    // thread announces the generation it holds in its epoch slot, and a replaced job
+    // is freed once every slot has moved past it.
+    static constexpr uint64_t JOB_EPOCH_IDLE = UINT64_MAX;
+    struct alignas(64) JobEpoch {
+        std::atomic<uint64_t> generation{JOB_EPOCH_IDLE};
+    };
+    std::atomic<const MiningJob*> m_job;
+    std::atomic<uint64_t> m_jobGeneration;
+    std::mutex m_publishMutex;
+    std::vector<std::unique_ptr<const MiningJob>> m_retiredJobs;
+    std::unique_ptr<JobEpoch[]> m_jobEpochs;
+    size_t m_jobEpochCount;
+    
+    // Job switch latency: generation << 16 | mining threads already on it; the last
+    // thread to switch records the time since the notify
+    std::atomic<uint64_t> m_jobSwitchState;
+    std::atomic<int> m_activeMiners;
     
     // Threading
     std::vector<std::thread> m_miningThreads;
     std::thread m_communicationThread;
     std::thread m_idleThread;
+    std::thread m_seedThread;
+    std::thread m_submitThread;
+    
+    // Share submission: mining threads push found shares onto m_shareQueue and go
+    // back to hashing. submitLoop() sends them and files each JSON-RPC id in
+    // m_pendingShares; communicationLoop(), the only reader of the socket, matches
+    // the pool's answers against it.
+    ShareQueue m_shareQueue;
+    std::mutex m_pendingMutex;
+    std::unordered_map<uint64_t, PendingShare> m_pendingShares;
+    std::mutex m_sendMutex;  // one writer on the socket at a time; also guards closing and replacing m_socket
+    std::string m_receiveBuffer;  // partial line left from the last recv
+    
+    // Seed hash state: the active dataset's seed and variant, the ones being built
+    // in the background, and the first job for them, held until the dataset is ready
+    std::mutex m_seedMutex;
+    std::string m_seedHash;
+    std::string m_nextSeedHash;
+    std::string m_algo;
+    std::string m_nextAlgo;
+    MiningJob m_pendingJob;
+    std::chrono::steady_clock::time_point m_pendingSince;
     
     // Idle detection
     int m_idleTime;
@@ -104,6 +211,7 @@ private:
     
     // RandomX
     std::unique_ptr<RandomX> m_randomx;
+    int m_tunedThreads; // thread count chosen by the tuner (0 = not tuned)
     
     // Performance monitoring
     std::unique_ptr<PerformanceMonitor> m_performanceMonitor;
@@ -112,6 +220,7 @@ private:
     std::atomic<uint64_t> m_sharesSubmitted;
     std::atomic<uint64_t> m_sharesAccepted;
     std::atomic<uint64_t> m_sharesRejected;
+    std::atomic<uint64_t> m_sharesStale;  // found for a replaced job and never sent
     std::atomic<uint32_t> m_submitId;
     
     // Methods
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Nonce space of one mining job, shared by all mining threads
+ * Threads claim contiguous chunks with a single fetch_add on a shared cursor, so
+ * no nonce is hashed twice or skipped and the job itself is never written while
+ * mining. With nicehash-style reserved bytes the pool fixes the top bytes of the
+ * nonce in the job blob; they are kept as sent and only the remaining low bits are
+ * handed out. Those free bits can be split further into equal slices so several
+ * local miners share one job without overlap.
+ */
+
+constexpr double NONCE_CHUNK_SECONDS = 0.5;    // hashing time one chunk should last at the thread's rate
+constexpr uint32_t NONCE_MAX_CHUNK = 1u << 16;
+constexpr uint32_t NONCE_MAX_RESERVED_BYTES = 3;
+constexpr uint32_t NONCE_MAX_INSTANCES = 256;
+
+// Nonces first, first + 1, ..., first + count - 1
+struct NonceRange {
+    uint32_t first;
+    uint32_t count;
+    
+    NonceRange() : first(0), count(0) {}
+};
+
+class NonceAllocator {
+public:
+    // reservedBytes (0-3) top bytes of poolNonce, the nonce field of the job blob, are
+    // kept in every nonce; the free bits are cut into instances slices and this
+    // allocator hands out slice instance (clamped to the last one)
+    explicit NonceAllocator(uint32_t reservedBytes = 0, uint32_t poolNonce = 0,
+                            uint32_t instances = 1, uint32_t instance = 0);
+    
+    // Claim up to count nonces; false once the job's nonce space is used up
+    bool claim(uint32_t count, NonceRange& range);
+    
+    // Nonces handed out so far and the size of the space
+    uint64_t getClaimed() const;
+    uint64_t getCapacity() const { return m_capacity; }
+    uint32_t getReservedBytes() const { return m_reservedBytes; }
+    uint32_t getBase() const { return m_base; }
+    
+    // Chunk for a thread hashing at hashRate H/s: NONCE_CHUNK_SECONDS of work,
+    // a whole number of batches, between one batch and NONCE_MAX_CHUNK
+    static uint32_t chunkSize(double hashRate, uint32_t batchSize);
+    
+private:
+    // The cursor is written by every thread; keep it off the line holding the constants
+    alignas(64) std::atomic<uint64_t> m_cursor;
+    alignas(64) uint64_t m_capacity;
+    uint32_t m_base;      // reserved bytes from the pool plus the start of this instance's slice
+    uint32_t m_reservedBytes;
+};
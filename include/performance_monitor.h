@@ -1,10 +1,34 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <thread>
 #include <mutex>
 #include <string>
+#include <vector>
+
+// Latencies in power-of-two millisecond buckets: bucket 0 holds everything under
+// 1 ms, bucket i holds [2^(i-1), 2^i) ms and the last one everything above
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKETS = 18;
+    
+    void record(double milliseconds);
+    void reset();
+    
+    uint64_t getCount() const { return m_count.load(); }
+    uint64_t getBucket(size_t index) const { return index < BUCKETS ? m_buckets[index].load() : 0; }
+    double getAverageMs() const;
+    // Upper bound of the bucket holding the given fraction (0-1) of samples
+    double getPercentileMs(double fraction) const;
+    static double bucketUpperMs(size_t index);
+    
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<double> m_totalMs{0.0};
+};
 
 class PerformanceMonitor {
 public:
@@ -17,22 +41,36 @@ public:
     
     // Statistics tracking
     void updateHashRate(double hashRate);
-    void updateShares(uint64_t submitted, uint64_t accepted, uint64_t rejected);
+    void updateNodeHashRates(const std::vector<double>& rates);
+    void updateShares(uint64_t submitted, uint64_t accepted, uint64_t rejected, uint64_t stale);
     void updateJobInfo(const std::string& jobId, const std::string& pool, double difficulty);
+    void recordJobSwitch(double milliseconds);
+    void recordShareLatency(double milliseconds);
     
     // Performance metrics
     double getCurrentHashRate() const;
     double getAverageHashRate() const;
     double getPeakHashRate() const;
+    std::vector<double> getNodeHashRates() const;
     uint64_t getTotalHashes() const;
     uint64_t getSharesSubmitted() const;
     uint64_t getSharesAccepted() const;
     uint64_t getSharesRejected() const;
+    uint64_t getSharesStale() const;
     double getAcceptanceRate() const;
     std::string getCurrentJob() const;
     std::string getCurrentPool() const;
     double getCurrentDifficulty() const;
     
+    // Job switches: time from a job notify until every mining thread hashes the new job
+    uint64_t getJobSwitches() const { return m_jobSwitches.load(); }
+    double getLastJobSwitchMs() const { return m_lastJobSwitchMs.load(); }
+    double getAverageJobSwitchMs() const;
+    double getMaxJobSwitchMs() const { return m_maxJobSwitchMs.load(); }
+    
+    // Time from sending a share to the pool's answer
+    const LatencyHistogram& getShareLatency() const { return m_shareLatency; }
+    
     // Display
     void displayStats();
     void startRealTimeDisplay();
@@ -47,15 +85,23 @@ private:
     std::atomic<double> m_currentHashRate;
     std::atomic<double> m_averageHashRate;
     std::atomic<double> m_peakHashRate;
+    std::vector<double> m_nodeHashRates;  // per NUMA node, guarded by m_nodeMutex
+    mutable std::mutex m_nodeMutex;
     std::atomic<uint64_t> m_totalHashes;
     std::atomic<uint64_t> m_sharesSubmitted;
     std::atomic<uint64_t> m_sharesAccepted;
     std::atomic<uint64_t> m_sharesRejected;
+    std::atomic<uint64_t> m_sharesStale;  // dropped before sending, not part of the acceptance rate
     
     // Job info
     std::string m_currentJob;
     std::string m_currentPool;
     std::atomic<double> m_currentDifficulty;
+    std::atomic<uint64_t> m_jobSwitches;
+    std::atomic<double> m_lastJobSwitchMs;
+    std::atomic<double> m_totalJobSwitchMs;
+    std::atomic<double> m_maxJobSwitchMs;
+    LatencyHistogram m_shareLatency;
     
     // Timing
     std::chrono::steady_clock::time_point m_startTime;
@@ -7,14 +7,94 @@
 #include <array>
 #include <random>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <bit>
+#include "cpu_topology.h"
+#include "randomx_aes.h"
+#include "randomx_blake2b.h"
+#include "randomx_argon2.h"
 
 // RandomX constants
-constexpr size_t RANDOMX_CACHE_SIZE = 2097152; // 2MB
+constexpr size_t RANDOMX_CACHE_SIZE = 268435456; // 256MB, the whole light-mode footprint
+constexpr uint32_t RANDOMX_ARGON_LANES = 8; // independent Argon2d lanes, the cache build's parallelism
+constexpr size_t RANDOMX_DATASET_ITEM_ACCESSES = 8; // cache lines mixed into each dataset item
 constexpr size_t RANDOMX_DATASET_SIZE = 1073741824; // 1GB
+constexpr size_t RANDOMX_DATASET_CHUNK_SIZE = 2097152; // 2MB unit of parallel init, page aligned for 4K/16K/2M pages
 constexpr size_t RANDOMX_PROGRAM_SIZE = 256;
 constexpr size_t RANDOMX_PROGRAM_COUNT = 8;
-constexpr size_t RANDOMX_SCRATCHPAD_SIZE = 2097152; // 2MB
+constexpr size_t RANDOMX_SCRATCHPAD_SIZE = 2097152; // 2MB, the rx/0 L3 tier and the largest of any variant
+constexpr size_t RANDOMX_SCRATCHPAD_L2_SIZE = 262144; // 256KB, the part of each scratchpad that should stay in L2
+constexpr size_t RANDOMX_SCRATCHPAD_L1_SIZE = 16384; // 16KB, the part that should stay in L1
 constexpr size_t RANDOMX_HASH_SIZE = 32;
+constexpr size_t RANDOMX_MAX_BATCH_SIZE = 4; // nonces hashed in lockstep per worker
+constexpr uint32_t RANDOMX_DEFAULT_PREFETCH_DISTANCE = 8; // instructions ahead of a memory operand
+constexpr uint32_t RANDOMX_MAX_PREFETCH_DISTANCE = 64;
+
+// RandomX-family parameter sets. Code templated on RandomXParams<V> (program tier
+// assignment, scratchpad fill and checksum, the Argon2d cache build) is compiled
+// once per variant with its sizes as constants; the execution engines read the
+// tier stored in each instruction and never test the variant.
+enum class RandomXVariant {
+    RX_0,    // Monero
+    RX_WOW,  // Wownero
+    RX_ARQ   // ArQmA
+};
+
+template <RandomXVariant V>
+struct RandomXParams;
+
+template <>
+struct RandomXParams<RandomXVariant::RX_0> {
+    static constexpr RandomXVariant variant = RandomXVariant::RX_0;
+    static constexpr const char* name = "rx/0";
+    static constexpr const char* family = "randomx";
+    static constexpr size_t scratchpadL3 = RANDOMX_SCRATCHPAD_SIZE;
+    static constexpr size_t scratchpadL2 = RANDOMX_SCRATCHPAD_L2_SIZE;
+    static constexpr size_t scratchpadL1 = RANDOMX_SCRATCHPAD_L1_SIZE;
+    static constexpr uint32_t argonPasses = 3;
+    static constexpr char argonSalt[] = "RandomX\x03";
+};
+
+template <>
+struct RandomXParams<RandomXVariant::RX_WOW> {
+    static constexpr RandomXVariant variant = RandomXVariant::RX_WOW;
+    static constexpr const char* name = "rx/wow";
+    static constexpr const char* family = "randomwow";
+    static constexpr size_t scratchpadL3 = 1048576;
+    static constexpr size_t scratchpadL2 = 131072;
+    static constexpr size_t scratchpadL1 = 16384;
+    static constexpr uint32_t argonPasses = 3;
+    static constexpr char argonSalt[] = "RandomWOW\x01";
+};
+
+template <>
+struct RandomXParams<RandomXVariant::RX_ARQ> {
+    static constexpr RandomXVariant variant = RandomXVariant::RX_ARQ;
+    static constexpr const char* name = "rx/arq";
+    static constexpr const char* family = "randomarq";
+    static constexpr size_t scratchpadL3 = 262144;
+    static constexpr size_t scratchpadL2 = 131072;
+    static constexpr size_t scratchpadL1 = 16384;
+    static constexpr uint32_t argonPasses = 1;
+    static constexpr char argonSalt[] = "RandomARQ\x01";
+};
+
+// Run f.template operator()<RandomXParams<V>>() for a runtime variant; the switch
+// happens once per call, not inside whatever f loops over
+template <typename F>
+decltype(auto) visitRandomXVariant(RandomXVariant variant, F&& f) {
+    switch (variant) {
+        case RandomXVariant::RX_WOW:
+            return f.template operator()<RandomXParams<RandomXVariant::RX_WOW>>();
+        case RandomXVariant::RX_ARQ:
+            return f.template operator()<RandomXParams<RandomXVariant::RX_ARQ>>();
+        case RandomXVariant::RX_0:
+        default:
+            return f.template operator()<RandomXParams<RandomXVariant::RX_0>>();
+    }
+}
 
 // RandomX instruction types
 enum class RandomXInstructionType {
@@ -60,6 +140,57 @@ struct RandomXInstruction {
     uint8_t mod;
     uint8_t modShift;
     uint8_t modMask;
+    uint8_t tier;  // log2 of the scratchpad tier a memory operand or ISTORE addresses, for the VM's variant
+};
+
+class RandomXJitCompiler;
+
+// RandomX execution engines
+enum class RandomXEngine {
+    INTERPRETER,  // switch dispatch over RandomXInstruction
+    THREADED,     // computed-goto dispatch over pre-decoded instructions
+    JIT           // native x86-64 code, falls back to THREADED where unavailable
+};
+
+// Pre-decoded instruction for the threaded engine (8 bytes, decoded once per program)
+struct RandomXDecodedInstruction {
+    uint8_t opcode;   // handler index (RandomXInstructionType, RANDOMX_DECODED_PREFETCH or RANDOMX_DECODED_HALT)
+    uint8_t dst;      // resolved register index
+    uint8_t src;      // resolved register index
+    uint8_t shift;    // modShift, or log2 of the scratchpad tier for memory operands and ISTORE
+    uint32_t imm32;   // immediate, or constant pool index for IMUL_RCP
+};
+static_assert(sizeof(RandomXDecodedInstruction) == 8, "decoded instructions must stay 8 bytes");
+
+constexpr uint8_t RANDOMX_DECODED_PREFETCH = 30; // prefetch the scratchpad word a later memory operand reads
+constexpr uint8_t RANDOMX_DECODED_ZERO_REGISTER = 8; // src of memory operands addressed by imm32 alone
+constexpr uint8_t RANDOMX_DECODED_HALT = 31;
+
+// Float register: two doubles every F instruction applies to at once (one SSE2/NEON
+// vector). Memory operands supply two signed 32-bit integers, one per lane.
+struct alignas(16) RandomXFloatRegister {
+    double lo;
+    double hi;
+};
+static_assert(sizeof(RandomXFloatRegister) == 16, "float registers must stay one 128-bit vector");
+
+// CFROUND modes in MXCSR rounding-control order: nearest, down, up, toward zero
+constexpr uint32_t RANDOMX_ROUNDING_NEAREST = 0;
+constexpr uint64_t RANDOMX_FDIV_NONZERO_MASK = 0x0000000100000001ULL; // sets bit 0 of both FDIV_M divisor lanes
+
+// Prefetch schedule entry: before executing instruction `issue`, prefetch the
+// scratchpad address of memory operand `target` (its source register is final by then)
+struct RandomXPrefetchHint {
+    uint8_t issue;
+    uint8_t target;
+};
+
+// Memory modes: FAST precomputes the full dataset, LIGHT keeps only the cache
+// and computes dataset items on demand, AUTO tries FAST and falls back to LIGHT
+enum class MemoryMode {
+    FAST,
+    LIGHT,
+    AUTO
 };
 
 // RandomX dataset item
@@ -67,23 +198,112 @@ struct RandomXDatasetItem {
     uint64_t data[8];
 };
 
+// Page backing of a large RandomX allocation, best first
+enum class RandomXPages {
+    HUGE_1G,      // explicit 1 GiB hugetlb pages
+    HUGE_2M,      // explicit 2 MiB hugetlb pages
+    TRANSPARENT,  // madvise(MADV_HUGEPAGE), 2 MiB aligned
+    STANDARD      // base pages
+};
+
+struct RandomXMemoryBlock {
+    void* memory = nullptr;
+    size_t size = 0;            // mapped size, rounded up to the page size
+    RandomXPages pages = RandomXPages::STANDARD;
+    bool mapped = false;        // released with munmap rather than free
+};
+
+// Large allocations for the dataset and cache. With useHugePages the Linux path
+// tries 1 GiB pages, then 2 MiB pages, then transparent huge pages, logging each
+// fallback; otherwise (and on other platforms) memory comes from aligned_alloc.
+// Memory is RANDOMX_DATASET_CHUNK_SIZE aligned and left untouched.
+namespace RandomXMemory {
+    RandomXMemoryBlock allocate(size_t size, bool useHugePages, const std::string& purpose);
+    void release(RandomXMemoryBlock& block);
+    std::string pagesToString(RandomXPages pages);
+    
+    // Free/total explicit huge pages and the transparent huge page mode
+    std::string hugePageStatus();
+}
+
 // RandomX cache
 class RandomXCache {
 public:
     RandomXCache();
     ~RandomXCache();
     
-    bool initialize(const uint8_t* key, size_t keySize);
+    // Light mode allocates only the cache; initThreads 0 = one cache and dataset init
+    // thread per hardware thread (the cache build uses at most RANDOMX_ARGON_LANES)
+    bool initialize(const uint8_t* key, size_t keySize, bool lightMode = false, int initThreads = 0);
     void destroy();
-    const RandomXDatasetItem* getDatasetItem(uint32_t index) const;
+    bool isLightMode() const { return m_lightMode; }
+    
+    // Parameter set of the Argon2d build; VMs bound to the cache take it over.
+    // Set before initialize().
+    void setVariant(RandomXVariant variant) { m_variant = variant; }
+    RandomXVariant getVariant() const { return m_variant; }
+    
+    // Directory of persisted datasets keyed by the cache key (empty = disabled).
+    // Set before initialize(); a valid file is mapped read-only instead of regenerated.
+    void setDatasetCacheDir(const std::string& directory) { m_datasetCacheDir = directory; }
+    bool isDatasetFromFile() const { return m_datasetFromFile; }
+    
+    // Back the cache and dataset with huge pages where available; set before initialize()
+    void setUseHugePages(bool useHugePages) { m_useHugePages = useHugePages; }
+    RandomXPages getDatasetPages() const { return m_replicas.empty() ? m_datasetMemory.pages : m_replicas[0].pages; }
+    
+    // With more than one node, the dataset is copied to each node after it is built
+    // and getDatasetItem() reads the copy of the given node; set before initialize()
+    void setNumaNodes(const std::vector<NumaNode>& nodes) { m_numaNodes = nodes; }
+    size_t getReplicaCount() const { return m_replicas.empty() ? 1 : m_replicas.size(); }
+    
+    // Precomputed dataset item (nullptr in light mode)
+    const RandomXDatasetItem* getDatasetItem(uint32_t index, size_t node = 0) const;
+    
+    // Compute a dataset item from the cache; valid in both modes
+    void computeDatasetItem(uint32_t index, RandomXDatasetItem& item) const;
+    
+    // Compute count consecutive items with the dataset kernel chosen from CPU features
+    void computeDatasetItems(uint32_t firstIndex, size_t count, RandomXDatasetItem* items) const;
+    static std::string datasetKernel();
+    
+    // Dataset initialization progress (0.0-1.0) and duration of the last initialize(),
+    // and of its Argon2d cache build alone
+    double getInitProgress() const;
+    double getInitSeconds() const { return m_initSeconds; }
+    double getCacheSeconds() const { return m_cacheSeconds; }
     
 private:
     void* m_cache;
     void* m_dataset;
+    RandomXMemoryBlock m_cacheMemory;
+    RandomXMemoryBlock m_datasetMemory;
+    bool m_useHugePages;
     bool m_initialized;
+    bool m_lightMode;
+    RandomXVariant m_variant;
+    std::atomic<size_t> m_chunksGenerated;
+    double m_initSeconds;
+    double m_cacheSeconds;
     
-    void generateCache(const uint8_t* key, size_t keySize);
-    void generateDataset();
+    // Persisted dataset: m_dataset points into m_datasetMapping when loaded from file
+    std::string m_datasetCacheDir;
+    void* m_datasetMapping;
+    size_t m_datasetMappingSize;
+    bool m_datasetFromFile;
+    
+    // Per-node dataset copies (empty = one shared dataset)
+    std::vector<NumaNode> m_numaNodes;
+    std::vector<RandomXMemoryBlock> m_replicas;
+    bool replicateDataset();
+    
+    std::string datasetFilePath(const uint8_t* key, size_t keySize) const;
+    bool loadDatasetFile(const std::string& path, const uint8_t* key, size_t keySize, double& coldSeconds);
+    bool saveDatasetFile(const std::string& path, const uint8_t* key, size_t keySize) const;
+    
+    bool generateCache(const uint8_t* key, size_t keySize, int threads);
+    void generateDataset(int threadCount);
+    void generateDatasetChunk(size_t chunk);
 };
 
 // RandomX VM
@@ -92,20 +312,75 @@ public:
     RandomXVM();
     ~RandomXVM();
     
-    bool initialize(RandomXCache* cache, bool lightMode = false);
+    // scratchpad: RANDOMX_SCRATCHPAD_SIZE bytes, 64-byte aligned, from the caller's
+    // arena; nullptr allocates one owned by the VM
+    bool initialize(RandomXCache* cache, bool lightMode = false, void* scratchpad = nullptr);
     void destroy();
     
+    // Rebind to another cache built in the same memory mode (between hashes only);
+    // the VM switches to the cache's variant
+    void setCache(RandomXCache* cache);
+    
+    // Parameter set programs are generated for (follows the cache when there is one)
+    void setVariant(RandomXVariant variant) { m_variant = variant; }
+    RandomXVariant getVariant() const { return m_variant; }
+    size_t getScratchpadSize() const;
+    
+    // Dataset replica (NUMA node index) this VM reads
+    void setNumaNode(size_t node) { m_numaNode = node; }
+    size_t getNumaNode() const { return m_numaNode; }
+    
     void reset();
     void loadProgram(const uint8_t* seed, size_t seedSize);
     void execute();
     
+    // Execute several loaded programs instruction by instruction in lockstep so
+    // one VM's memory operands overlap the others' arithmetic
+    static void executeLockstep(RandomXVM* const* vms, size_t count);
+    
+    // Execution engine selection
+    void setEngine(RandomXEngine engine);
+    RandomXEngine getEngine() const { return m_engine; }
+    
+    // How many instructions ahead of a memory operand its scratchpad word is prefetched (0 = off)
+    void setPrefetchDistance(uint32_t distance);
+    uint32_t getPrefetchDistance() const { return m_prefetchDistance; }
+    size_t getPrefetchHintCount() const { return m_prefetchHintCount; }
+    
     // Register access
     uint64_t getRegister(int index) const;
     void setRegister(int index, uint64_t value);
+    double getFloatRegister(int index, int lane = 0) const;
     
-    // Scratchpad access
+    // Scratchpad access (index in 8-byte words)
     uint64_t getScratchpad(int index) const;
     void setScratchpad(int index, uint64_t value);
+    const uint64_t* getScratchpadData() const { return m_scratchpad; }
+    
+    // Scratchpad tier of a memory operand or ISTORE under Params, as log2 of its
+    // size in bytes. Loads use L1 or L2 at r[src] + imm32, or all of L3 at imm32
+    // alone when src == dst; ISTORE writes one of the three tiers at r[dst] + imm32.
+    // Three in four accesses stay in L1, as with RandomX's mod.mem; one in eight
+    // stores goes to L3, matching its mod.cond >= 14 share.
+    template <typename Params>
+    static constexpr uint8_t loadTier(const RandomXInstruction& instruction) {
+        if ((instruction.src & 7) == (instruction.dst & 7)) {
+            return std::countr_zero(Params::scratchpadL3);
+        }
+        return (instruction.mod & 3) ? std::countr_zero(Params::scratchpadL1) : std::countr_zero(Params::scratchpadL2);
+    }
+    template <typename Params>
+    static constexpr uint8_t storeTier(const RandomXInstruction& instruction) {
+        if (instruction.mod == 4) {
+            return std::countr_zero(Params::scratchpadL3);
+        }
+        return (instruction.mod & 3) ? std::countr_zero(Params::scratchpadL1) : std::countr_zero(Params::scratchpadL2);
+    }
+    static uint32_t tierMask(uint8_t tier) { return ((1u << tier) - 1) & ~7u; }
+    
+    // Program generation alone; loadProgram() also fills the scratchpad from the
+    // same AES stream and decodes or compiles the program for the engine
+    void generateProgram(const uint8_t* seed, size_t seedSize);
     
     // Program access
     const RandomXInstruction& getInstruction(int index) const;
@@ -116,32 +391,74 @@ public:
     uint64_t getCycleCount() const { return m_cycleCount; }
     
 private:
-    // Registers
-    std::array<uint64_t, 8> m_registers;
-    std::array<double, 8> m_fregisters;
+    // Registers, plus an always-zero slot decoded memory operands can address from
+    std::array<uint64_t, 9> m_registers;
+    std::array<RandomXFloatRegister, 8> m_fregisters;
+    
+    // Scratchpad (an arena slice, or m_scratchpadMemory when the VM owns it)
+    uint64_t* m_scratchpad;
+    RandomXMemoryBlock m_scratchpadMemory;
     
-    // Scratchpad
-    std::array<uint64_t, 8> m_scratchpad;
+    // AES generator state after the program words, continued by the scratchpad fill
+    alignas(64) uint8_t m_aesState[RANDOMX_AES_STATE_SIZE];
     
     // Program
     std::array<RandomXInstruction, RANDOMX_PROGRAM_SIZE> m_program;
     int m_programCounter;
     
+    // Pre-decoded program for the threaded engine: every instruction plus at most
+    // one prefetch per instruction, and the halt sentinel
+    std::array<RandomXDecodedInstruction, 2 * RANDOMX_PROGRAM_SIZE + 1> m_decodedProgram;
+    std::array<uint64_t, RANDOMX_PROGRAM_SIZE> m_decodedConstants;
+    bool m_decodedValid;
+    RandomXEngine m_engine;
+    
+    // Scratchpad prefetch schedule, sorted by issue index
+    uint32_t m_prefetchDistance;
+    std::array<RandomXPrefetchHint, RANDOMX_PROGRAM_SIZE> m_prefetchHints;
+    size_t m_prefetchHintCount;
+    
+    // JIT backend (created on first use)
+    std::unique_ptr<RandomXJitCompiler> m_jit;
+    bool m_jitValid;
+    
     // Execution state
     uint64_t m_instructionCount;
     uint64_t m_cycleCount;
     uint32_t m_branchRegister;
     uint32_t m_branchTarget;
     
+    // Rounding mode last set by CFROUND; the FPU is only touched when it changes
+    uint32_t m_roundingMode;
+    
     // Cache reference
     RandomXCache* m_cache;
+    RandomXVariant m_variant;
+    size_t m_numaNode;
     bool m_lightMode;
     bool m_initialized;
     
+    // Dataset item the loaded program mixes in (RandomX's ma): derived from the
+    // program seed, so every engine prefetches it before the first instruction
+    uint32_t m_datasetIndex;
+    
+    // Last dataset item computed in light mode
+    RandomXDatasetItem m_lightItem;
+    uint32_t m_lightItemIndex;
+    
     // RNG
     std::mt19937_64 m_rng;
     
     // Instruction execution
+    void executeInterpreted();
+    void executeThreaded();
+    void executeJit();
+    bool compileJit();
+    void decodeProgram();
+    void buildPrefetchHints();
+    void fillScratchpad();
+    void prefetchDatasetItem() const;
+    void mixDatasetItem();
     void executeInstruction(const RandomXInstruction& instruction);
     void executeIADD_RS(const RandomXInstruction& instruction);
     void executeIADD_M(const RandomXInstruction& instruction);
@@ -175,18 +492,21 @@ private:
     void executeNOP(const RandomXInstruction& instruction);
     
     // Utility functions
-    uint64_t rotateRight64(uint64_t x, int n);
-    uint64_t rotateLeft64(uint64_t x, int n);
-    uint64_t mulh(uint64_t a, uint64_t b);
-    int64_t smulh(int64_t a, int64_t b);
-    double int64ToDouble(uint64_t x);
-    uint64_t doubleToInt64(double x);
+    static uint64_t rotateRight64(uint64_t x, int n);
+    static uint64_t rotateLeft64(uint64_t x, int n);
+    static uint64_t mulh(uint64_t a, uint64_t b);
+    static int64_t smulh(int64_t a, int64_t b);
+    static double int64ToDouble(uint64_t x);
+    static uint64_t doubleToInt64(double x);
+    static void setRoundingMode(uint32_t mode);
     
     // Program generation
-    void generateProgram(const uint8_t* seed, size_t seedSize);
-    RandomXInstruction generateInstruction(uint32_t pc, const uint8_t* seed, size_t seedSize);
+    static void decodeInstruction(uint64_t word, RandomXInstruction& instruction);
+    void assignTier(RandomXInstruction& instruction) const;
     uint32_t getRegisterMask(const RandomXInstruction& instruction);
     uint32_t getMemoryAddress(const RandomXInstruction& instruction);
+    static bool readsScratchpad(RandomXInstructionType type);
+    static bool writesRegister(const RandomXInstruction& instruction, uint8_t reg);
 };
 
 // Main RandomX class
@@ -195,47 +515,158 @@ public:
     RandomX();
     ~RandomX();
     
-    // Initialize RandomX algorithm
-    bool initialize(const uint8_t* key, size_t keySize, bool lightMode = false);
+    // Initialize RandomX algorithm (workerCount 0 = one VM per hardware thread)
+    bool initialize(const uint8_t* key, size_t keySize, bool lightMode = false, int workerCount = 0);
+    bool initialize(const uint8_t* key, size_t keySize, MemoryMode mode, int workerCount = 0);
     void destroy();
     
+    // Resolved memory mode (FAST or LIGHT) once initialized
+    MemoryMode getMemoryMode() const { return m_lightMode ? MemoryMode::LIGHT : MemoryMode::FAST; }
+    static MemoryMode memoryModeFromString(const std::string& name);
+    static std::string memoryModeToString(MemoryMode mode);
+    
+    // Worker management - each hashing thread owns one VM per batch lane for its lifetime
+    int acquireWorker();
+    void releaseWorker(int workerId);
+    int getWorkerCount() const { return static_cast<int>(m_workerInUse.size()); }
+    
+    // Lanes per worker for batched hashing (1-RANDOMX_MAX_BATCH_SIZE, set before initialize)
+    void setBatchSize(size_t batchSize);
+    size_t getBatchSize() const { return m_batchSize; }
+    
     // Calculate hash for given input
     void calculateHash(const uint8_t* input, size_t inputSize, uint8_t* output);
+    void calculateHash(int workerId, const uint8_t* input, size_t inputSize, uint8_t* output);
+    
+    // Hash count equally sized inputs laid out back to back; outputs receives
+    // count * RANDOMX_HASH_SIZE bytes. Runs up to getBatchSize() nonces in lockstep.
+    void calculateHashBatch(int workerId, const uint8_t* inputs, size_t inputSize, size_t count, uint8_t* outputs);
     
     // Check if hash meets target
     bool isValidHash(const uint8_t* hash, const uint8_t* target);
     
     // Performance monitoring
     double getHashRate() const;
-    uint64_t getTotalHashes() const { return m_totalHashes; }
-    uint64_t getValidHashes() const { return m_validHashes; }
+    uint64_t getTotalHashes() const { return m_totalHashes.load(); }
+    uint64_t getValidHashes() const { return m_validHashes.load(); }
     double getAcceptanceRate() const;
     
+    // Execution engine used by all worker VMs
+    void setEngine(RandomXEngine engine);
+    RandomXEngine getEngine() const { return m_engine; }
+    static RandomXEngine engineFromString(const std::string& name);
+    static std::string engineToString(RandomXEngine engine);
+    
+    // RandomX variant of every cache built from now on (set before initialize, or
+    // pass one to prepareNextKey to switch along with the key); accepts rx/0, rx/wow
+    // and rx/arq or the randomx, randomwow and randomarq family names
+    void setVariant(RandomXVariant variant) { m_variant = variant; }
+    RandomXVariant getVariant() const { return m_variant; }
+    static bool variantFromString(const std::string& name, RandomXVariant& variant);
+    static std::string variantToString(RandomXVariant variant);
+    
+    // Scratchpad prefetch distance used by all worker VMs
+    void setPrefetchDistance(uint32_t distance);
+    uint32_t getPrefetchDistance() const { return m_prefetchDistance; }
+    
+    // Directory for persisted datasets, applied to every key (empty = disabled)
+    void setDatasetCacheDir(const std::string& directory) { m_datasetCacheDir = directory; }
+    const std::string& getDatasetCacheDir() const { return m_datasetCacheDir; }
+    
+    // NUMA placement: one dataset replica per node and workers spread across nodes
+    // in contiguous blocks (set before initialize; ignored in light mode)
+    void setNumaEnabled(bool enabled) { m_numaEnabled = enabled; }
+    size_t getNumaNodeCount() const { return m_numaNodes.empty() ? 1 : m_numaNodes.size(); }
+    int getWorkerNumaNode(int workerId) const;
+    
+    // Pin the calling thread to the worker's CPU, or to the CPUs of its node
+    // (false with neither a CPU nor NUMA placement)
+    bool bindThreadToWorker(int workerId);
+    
+    // One CPU per worker from the thread tuner (empty = node-wide pinning only); moves
+    // each worker to the node of its CPU. Call while no worker is held.
+    void setWorkerCpus(const std::vector<int>& cpus);
+    const std::vector<int>& getWorkerCpus() const { return m_workerCpus; }
+    
+    // Hashes per second of the workers on each node since initialize
+    std::vector<double> getNodeHashRates() const;
+    
+    // Huge page backing for every cache and dataset (set before initialize)
+    void setUseHugePages(bool useHugePages) { m_useHugePages = useHugePages; }
+    bool getUseHugePages() const { return m_useHugePages; }
+    RandomXPages getDatasetPages() const { return m_cache ? m_cache->getDatasetPages() : RandomXPages::STANDARD; }
+    
+    // Key (seed hash) changes: the next cache and dataset are built on a background
+    // thread while workers keep hashing with the active key. activateNextKey() swaps
+    // them in; each worker rebinds before its next hash and the old dataset is freed
+    // once the last worker has moved off it.
+    bool prepareNextKey(const uint8_t* key, size_t keySize, int initThreads = 0);
+    bool prepareNextKey(const uint8_t* key, size_t keySize, RandomXVariant variant, int initThreads = 0);
+    bool isNextKeyBuilding() const { return m_nextCacheBuilding.load(); }
+    bool isNextKeyReady() const { return m_nextCacheReady.load(); }
+    bool activateNextKey();
+    uint64_t getKeyGeneration() const { return m_cacheGeneration.load(); }
+    
     // Utility functions
     static std::vector<uint8_t> hexToBytes(const std::string& hex);
     static std::string bytesToHex(const uint8_t* bytes, size_t length);
+    static std::string hexKernel();
     
     // Benchmarking
     double benchmark(uint32_t iterations = 1000);
+    double benchmarkThreads(int threadCount, uint32_t iterationsPerThread = 1000);
+    double benchmarkEngine(RandomXEngine engine, uint32_t programs = 1000); // ns per instruction
+    double benchmarkProgramGeneration(uint32_t programs = 100000); // ns per program
+    double benchmarkBatch(size_t batchSize, uint32_t iterations = 1000); // H/s on one worker
+    double benchmarkDatasetLatency(bool prefetch, uint32_t reads = 1 << 18); // ns per program-sized step
+    // Dependent random reads over a fresh buffer, to show the TLB cost of the page size
+    static double benchmarkPageLatency(bool useHugePages, RandomXPages& pages,
+                                       size_t bytes = RANDOMX_CACHE_SIZE, uint32_t reads = 1 << 20); // ns per read
     
 private:
-    RandomXCache* m_cache;
+    std::shared_ptr<RandomXCache> m_cache;
     std::vector<std::unique_ptr<RandomXVM>> m_vms;
+    RandomXMemoryBlock m_scratchpadArena; // one RANDOMX_SCRATCHPAD_SIZE slice per VM
     bool m_initialized;
     bool m_lightMode;
+    RandomXEngine m_engine;
+    RandomXVariant m_variant;
+    size_t m_batchSize;
+    uint32_t m_prefetchDistance;
+    std::string m_datasetCacheDir;
+    bool m_useHugePages;
+    
+    // NUMA placement (m_numaNodes empty = single node)
+    bool m_numaEnabled;
+    std::vector<NumaNode> m_numaNodes;
+    std::vector<size_t> m_workerNode;
+    std::vector<int> m_workerCpus;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_nodeHashes;
     
     // Performance tracking
-    uint64_t m_totalHashes;
-    uint64_t m_validHashes;
+    std::atomic<uint64_t> m_totalHashes;
+    std::atomic<uint64_t> m_validHashes;
     std::chrono::steady_clock::time_point m_startTime;
-    std::chrono::steady_clock::time_point m_lastHashTime;
     
     // Threading
     int m_threadCount;
+    std::vector<bool> m_workerInUse;
+    std::mutex m_workerMutex;
+    
+    // Key switching: m_cache is the active cache, guarded by m_cacheMutex while it
+    // is swapped; each worker keeps a reference to the cache its VMs are bound to
+    std::shared_ptr<RandomXCache> m_nextCache;
+    std::thread m_nextCacheThread;
+    std::atomic<bool> m_nextCacheBuilding;
+    std::atomic<bool> m_nextCacheReady;
+    std::atomic<uint64_t> m_cacheGeneration;
+    std::mutex m_cacheMutex;
+    std::vector<std::shared_ptr<RandomXCache>> m_workerCaches;
+    std::vector<uint64_t> m_workerGeneration;
     
     // Internal methods
-    void calculateHashInternal(const uint8_t* input, size_t inputSize, uint8_t* output);
-    void generateProgram(const uint8_t* seed, size_t seedSize, RandomXVM* vm);
-    void executeProgram(RandomXVM* vm);
-    void finalizeHash(const uint8_t* input, size_t inputSize, uint8_t* output);
+    RandomXVM* getWorkerVM(int workerId, size_t lane = 0) const;
+    void bindWorkerCache(int workerId);
+    void calculateHashInternal(RandomXVM* vm, const uint8_t* input, size_t inputSize, uint8_t* output);
+    void finalizeHash(const RandomXVM* vm, const uint8_t* input, size_t inputSize, uint8_t* output);
 };
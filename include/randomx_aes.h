@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * AES-round generator behind scratchpad fill and program generation
+ * Sixteen 16-byte columns each take one AES encryption round (AESENC) with their
+ * own fixed round key per step and are written out as the next 256 bytes. The
+ * stream is identical for every kernel; the fastest one the CPU supports is
+ * chosen once from CPUID.
+ */
+
+constexpr size_t RANDOMX_AES_STATE_SIZE = 256;  // 16 columns, also the bytes written per step
+
+enum class RandomXAesKernel {
+    SOFTWARE,   // table-driven, any CPU
+    AESNI,      // 128-bit AESENC per column (x86-64 AES-NI)
+    VAES        // four columns per 512-bit VAESENC (x86-64 VAES + AVX-512F)
+};
+
+class RandomXAes {
+public:
+    // Kernels this CPU and OS can run, slowest first (SOFTWARE is always present)
+    static const std::vector<RandomXAesKernel>& supportedKernels();
+    static bool isSupported(RandomXAesKernel kernel);
+
+    // Kernel used by fill(), detected on first use
+    static RandomXAesKernel activeKernel();
+    static std::string kernelToString(RandomXAesKernel kernel);
+
+    // One AESENC round: MixColumns(ShiftRows(SubBytes(input))) ^ key
+    static void encryptRound(RandomXAesKernel kernel, const uint8_t input[16], const uint8_t key[16], uint8_t output[16]);
+
+    // Advance the generator over size bytes (a multiple of RANDOMX_AES_STATE_SIZE),
+    // writing each step to output; state holds the last step afterwards
+    static void fill(uint8_t state[RANDOMX_AES_STATE_SIZE], void* output, size_t size);
+    static void fill(RandomXAesKernel kernel, uint8_t state[RANDOMX_AES_STATE_SIZE], void* output, size_t size);
+
+    // Fill throughput of one kernel in GB/s over a cache-resident buffer
+    static double benchmark(RandomXAesKernel kernel, size_t bufferSize, uint32_t repeats);
+};
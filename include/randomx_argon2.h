@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Argon2d (RFC 9106, version 0x13) memory fill for the RandomX cache
+ * Memory is a lanes x columns matrix of 1 KiB blocks. Each pass is cut into four
+ * slices; within a slice every lane is independent, so lanes are spread over
+ * threads with a barrier between slices. The block compression function has a
+ * scalar kernel and SSE2, AVX2 and AVX-512 kernels, chosen once from CPUID.
+ */
+
+constexpr size_t RANDOMX_ARGON2_BLOCK_SIZE = 1024;
+constexpr uint32_t RANDOMX_ARGON2_VERSION = 0x13;
+
+enum class RandomXArgon2Kernel {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Inputs of one Argon2d instance; secret and associated data are optional
+struct RandomXArgon2Params {
+    uint32_t memoryKiB;           // rounded down to a multiple of 4 * lanes blocks
+    uint32_t passes;
+    uint32_t lanes;
+    uint32_t tagSize;             // only enters H0 when just filling memory
+    const uint8_t* password;
+    size_t passwordSize;
+    const uint8_t* salt;
+    size_t saltSize;
+    const uint8_t* secret;
+    size_t secretSize;
+    const uint8_t* associatedData;
+    size_t associatedDataSize;
+
+    RandomXArgon2Params()
+        : memoryKiB(0), passes(0), lanes(1), tagSize(32), password(nullptr), passwordSize(0),
+          salt(nullptr), saltSize(0), secret(nullptr), secretSize(0), associatedData(nullptr),
+          associatedDataSize(0) {}
+};
+
+class RandomXArgon2 {
+public:
+    // Kernels this CPU and OS can run, slowest first (SCALAR is always present)
+    static const std::vector<RandomXArgon2Kernel>& supportedKernels();
+    static bool isSupported(RandomXArgon2Kernel kernel);
+    static RandomXArgon2Kernel activeKernel();
+    static std::string kernelToString(RandomXArgon2Kernel kernel);
+
+    // Blocks the parameters use (0 if they are invalid)
+    static size_t blockCount(const RandomXArgon2Params& params);
+
+    // Fill blockCount() blocks at memory, lane-major; threads 0 = one per lane
+    static bool fillMemory(void* memory, const RandomXArgon2Params& params, int threads = 0);
+    static bool fillMemory(void* memory, const RandomXArgon2Params& params, int threads, RandomXArgon2Kernel kernel);
+
+    // Complete Argon2d tag of params.tagSize bytes (allocates the memory)
+    static bool hash(void* tag, const RandomXArgon2Params& params, RandomXArgon2Kernel kernel);
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Blake2b (RFC 7693, unkeyed) for program seeding and hash finalization
+ * The compression function comes in a scalar and an AVX2 kernel that keeps the
+ * 4x4 working matrix in four 256-bit rows; the fastest supported one is chosen
+ * once at startup. Digests are 1-64 bytes (RandomX uses 64 to seed and 32 to finish).
+ */
+
+constexpr size_t RANDOMX_BLAKE2B_BLOCK_SIZE = 128;
+constexpr size_t RANDOMX_BLAKE2B_MAX_DIGEST = 64;
+
+enum class RandomXBlake2bKernel {
+    SCALAR,
+    AVX2
+};
+
+// Incremental state; init() selects the digest size and kernel
+struct RandomXBlake2bState {
+    uint64_t h[8];
+    uint64_t t[2];
+    uint8_t buffer[RANDOMX_BLAKE2B_BLOCK_SIZE];
+    size_t bufferSize;
+    size_t digestSize;
+    RandomXBlake2bKernel kernel;
+};
+
+class RandomXBlake2b {
+public:
+    // Kernels this CPU and OS can run, slowest first (SCALAR is always present)
+    static const std::vector<RandomXBlake2bKernel>& supportedKernels();
+    static bool isSupported(RandomXBlake2bKernel kernel);
+    static RandomXBlake2bKernel activeKernel();
+    static std::string kernelToString(RandomXBlake2bKernel kernel);
+
+    // Streaming interface; false for a digest size outside 1-64 bytes
+    static bool init(RandomXBlake2bState& state, size_t digestSize);
+    static bool init(RandomXBlake2bState& state, size_t digestSize, RandomXBlake2bKernel kernel);
+    static void update(RandomXBlake2bState& state, const void* data, size_t size);
+    static void final(RandomXBlake2bState& state, void* digest);
+
+    // One-shot digest with the active kernel
+    static bool hash(void* digest, size_t digestSize, const void* data, size_t size);
+
+    // Nanoseconds per input byte hashing one message of the given size
+    static double benchmark(RandomXBlake2bKernel kernel, size_t messageSize, uint32_t iterations);
+
+    // Time stamp counter ticks per nanosecond for cycles-per-byte figures (0 where unavailable)
+    static double cyclesPerNanosecond();
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+struct RandomXInstruction;
+struct RandomXPrefetchHint;
+
+/**
+ * x86-64 JIT backend for RandomX programs
+ * Compiles each generated program to native code in a W^X-managed buffer.
+ * VM integer registers live in r8-r15 and float registers (packed double
+ * pairs) in xmm0-xmm7.
+ */
+
+// Execution state handed to compiled programs (offsets are baked into the prologue)
+struct RandomXJitState {
+    uint64_t* registers;      // 8 integer registers
+    double* fregisters;       // 8 float registers, two 16-byte aligned doubles each
+    uint64_t* scratchpad;     // RANDOMX_SCRATCHPAD_SIZE bytes read by memory operands and written by ISTORE
+    uint32_t branchRegister;
+    uint32_t roundingMode;    // CFROUND mode in effect (in and out)
+    uint32_t mxcsr;           // MXCSR image CFROUND edits and reloads
+};
+
+class RandomXJitCompiler {
+public:
+    RandomXJitCompiler();
+    ~RandomXJitCompiler();
+
+    RandomXJitCompiler(const RandomXJitCompiler&) = delete;
+    RandomXJitCompiler& operator=(const RandomXJitCompiler&) = delete;
+
+    // True when this build has a JIT backend for the host architecture
+    static bool isSupported();
+
+    // Allocate the code buffer
+    bool initialize();
+    void destroy();
+
+    // Compile a program with an optional scratchpad prefetch schedule (sorted by issue);
+    // run() executes the last successfully compiled program
+    bool compile(const RandomXInstruction* program, size_t count,
+                 const RandomXPrefetchHint* hints = nullptr, size_t hintCount = 0);
+    void run(RandomXJitState* state) const;
+
+    bool isCompiled() const { return m_compiled; }
+    size_t getCodeSize() const { return m_codeSize; }
+
+private:
+    uint8_t* m_writeView;     // RW mapping (never executable)
+    uint8_t* m_execView;      // RX mapping (never writable)
+    size_t m_capacity;
+    size_t m_codeSize;
+    bool m_dualMapped;        // separate RW/RX views of one memfd, otherwise mprotect flips
+    bool m_compiled;
+
+    // Code emission
+    uint8_t* m_cursor;
+    bool beginWrite();
+    bool endWrite();
+    void emit8(uint8_t byte);
+    void emit32(uint32_t value);
+    void emit64(uint64_t value);
+    void emitRex(bool wide, int reg, int index, int base);
+    void emitModRM(int mod, int reg, int rm);
+    void emitRegReg(uint8_t opcode, int rm, int reg);
+    void emitRegMem(uint8_t prefix, bool wide, bool twoByte, uint8_t opcode, int reg);
+    void emitSse(uint8_t prefix, uint8_t opcode, int reg, int rm);
+    void emitLoad(int reg, int base, uint8_t disp);
+    void emitStore(int base, uint8_t disp, int reg);
+    void emitAddress(int src, uint32_t imm32, uint32_t mask);
+    void emitLoadAddress(const RandomXInstruction& instruction);
+    void emitPrefetch(const RandomXInstruction& instruction);
+
+    void emitPrologue();
+    void emitEpilogue();
+    void emitInstruction(const RandomXInstruction& instruction);
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Found shares on their way from the mining threads to the pool
+ * Mining threads push and go straight back to hashing; one submission thread pops.
+ * The queue is an unbounded linked list (Vyukov MPSC): a push is one atomic
+ * exchange plus one store, a pop touches only consumer-owned state.
+ */
+
+struct FoundShare {
+    std::string jobId;
+    uint64_t jobGeneration;  // MiningJob::generation; older than the current job means stale
+    uint32_t nonce;
+    std::array<uint8_t, 32> hash;
+    std::chrono::steady_clock::time_point foundAt;
+    
+    FoundShare() : jobGeneration(0), nonce(0), hash{} {}
+};
+
+class ShareQueue {
+public:
+    ShareQueue();
+    ~ShareQueue();
+    
+    ShareQueue(const ShareQueue&) = delete;
+    ShareQueue& operator=(const ShareQueue&) = delete;
+    
+    // Any thread, lock-free
+    void push(std::unique_ptr<FoundShare> share);
+    
+    // Consumer thread only: the oldest share, or nullptr when none is ready
+    std::unique_ptr<FoundShare> pop();
+    
+    // Consumer thread only: sleep until a push() after the last empty pop(), or close()
+    void wait();
+    
+    // close() releases the consumer for good; shares already queued can still be popped
+    void close();
+    void open();
+    bool isClosed() const;
+    
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        std::unique_ptr<FoundShare> share;
+        
+        Node() : next(nullptr) {}
+    };
+    
+    // Producers swing m_head; the consumer owns m_tail, whose node is already consumed
+    alignas(64) std::atomic<Node*> m_head;
+    alignas(64) Node* m_tail;
+    alignas(64) std::atomic<uint32_t> m_signal;
+    std::atomic<bool> m_closed;
+};
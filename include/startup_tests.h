@@ -142,10 +142,12 @@ private:
     bool testNetworkConnectivity();
     bool testMiningComponents();
     bool testMemoryManagement();
+    bool testHugePages();
     bool testPerformanceMonitoring();
     bool testSecurityValidation();
     bool testSystemIntegration();
     bool testRandomXAlgorithm();
+    bool testRandomXCacheInit();
     bool testPoolConnections();
     bool testWalletValidation();
     bool testCLIInterface();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class RandomX;
+
+/**
+ * Mining thread count and affinity tuner
+ * Proposes threads from the cache and core topology, confirms the choice with a
+ * short RandomX calibration run and stores the result for later starts.
+ */
+
+struct ThreadPlan {
+    int threads;              // mining threads
+    std::vector<int> cpus;    // CPU of each worker in order (empty = unpinned)
+    double hashRate;          // calibrated H/s (0 = not measured)
+    std::string reason;       // how the plan was chosen, for logs
+    
+    ThreadPlan() : threads(0), hashRate(0.0) {}
+};
+
+class ThreadTuner {
+public:
+    // Topology-only proposal: one thread per physical core while every L3 keeps a
+    // full scratchpad per thread; SMT siblings join only when the core's L2 also
+    // holds the L2 part of each sibling's scratchpad
+    static ThreadPlan propose();
+    
+    // Benchmark the proposal against all physical cores and all hardware threads
+    // and keep the fastest; randomx must be initialized with enough workers
+    static ThreadPlan calibrate(RandomX& randomx, const ThreadPlan& proposal, uint32_t iterationsPerThread = 200);
+    
+    // Identifies the host and RandomX settings a stored plan is valid for
+    static std::string fingerprint(const RandomX& randomx);
+    
+    // Stored plans (flat JSON); load fails when the fingerprint differs
+    static bool load(const std::string& path, const std::string& fingerprint, ThreadPlan& plan);
+    static bool save(const std::string& path, const std::string& fingerprint, const ThreadPlan& plan);
+};
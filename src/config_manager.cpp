@@ -67,7 +67,18 @@ bool ConfigManager::saveToFile(const std::string& filename) const {
     json << "    \"threads\": " << m_miningConfig.threads << ",\n";
     json << "    \"useGPU\": " << (m_miningConfig.useGPU ? "true" : "false") << ",\n";
     json << "    \"useHugePages\": " << (m_miningConfig.useHugePages ? "true" : "false") << ",\n";
-    json << "    \"intensity\": " << m_miningConfig.intensity << "\n";
+    json << "    \"intensity\": " << m_miningConfig.intensity << ",\n";
+    json << "    \"engine\": \"" << m_miningConfig.engine << "\",\n";
+    json << "    \"batchSize\": " << m_miningConfig.batchSize << ",\n";
+    json << "    \"prefetchDistance\": " << m_miningConfig.prefetchDistance << ",\n";
+    json << "    \"nonceReservedBytes\": " << m_miningConfig.nonceReservedBytes << ",\n";
+    json << "    \"nonceInstances\": " << m_miningConfig.nonceInstances << ",\n";
+    json << "    \"nonceInstance\": " << m_miningConfig.nonceInstance << ",\n";
+    json << "    \"memoryMode\": \"" << m_miningConfig.memoryMode << "\",\n";
+    json << "    \"datasetCacheDir\": \"" << m_miningConfig.datasetCacheDir << "\",\n";
+    json << "    \"numa\": " << (m_miningConfig.numa ? "true" : "false") << ",\n";
+    json << "    \"autoTune\": " << (m_miningConfig.autoTune ? "true" : "false") << ",\n";
+    json << "    \"tuningFile\": \"" << m_miningConfig.tuningFile << "\"\n";
     json << "  },\n";
     json << "  \"pool\": {\n";
     json << "    \"url\": \"" << m_poolConfig.url << "\",\n";
@@ -228,6 +239,17 @@ void ConfigManager::resetToDefaults() {
     m_miningConfig.useGPU = true;
     m_miningConfig.useHugePages = false;
     m_miningConfig.intensity = 100;
+    m_miningConfig.engine = "threaded";
+    m_miningConfig.batchSize = 2;
+    m_miningConfig.prefetchDistance = 8;
+    m_miningConfig.nonceReservedBytes = 0;
+    m_miningConfig.nonceInstances = 1;
+    m_miningConfig.nonceInstance = 0;
+    m_miningConfig.memoryMode = "auto";
+    m_miningConfig.datasetCacheDir = "";
+    m_miningConfig.numa = true;
+    m_miningConfig.autoTune = true;
+    m_miningConfig.tuningFile = "thread_tuning.json";
     
     // Set default pool configuration
     m_poolConfig.url = "";
@@ -275,6 +297,17 @@ bool ConfigManager::parseJsonConfig(const std::string& jsonData) {
     m_miningConfig.useGPU = json.getBool("mining.useGPU", true);
     m_miningConfig.useHugePages = json.getBool("mining.useHugePages", false);
     m_miningConfig.intensity = json.getInt("mining.intensity", 100);
+    m_miningConfig.engine = json.getString("mining.engine", "threaded");
+    m_miningConfig.batchSize = json.getInt("mining.batchSize", 2);
+    m_miningConfig.prefetchDistance = json.getInt("mining.prefetchDistance", 8);
+    m_miningConfig.nonceReservedBytes = json.getInt("mining.nonceReservedBytes", 0);
+    m_miningConfig.nonceInstances = json.getInt("mining.nonceInstances", 1);
+    m_miningConfig.nonceInstance = json.getInt("mining.nonceInstance", 0);
+    m_miningConfig.memoryMode = json.getString("mining.memoryMode", "auto");
+    m_miningConfig.datasetCacheDir = json.getString("mining.datasetCacheDir", "");
+    m_miningConfig.numa = json.getBool("mining.numa", true);
+    m_miningConfig.autoTune = json.getBool("mining.autoTune", true);
+    m_miningConfig.tuningFile = json.getString("mining.tuningFile", "thread_tuning.json");
     
     // Parse pool configuration (flat JSON structure)
     m_poolConfig.url = json.getString("pool.url", "");
@@ -323,6 +356,47 @@ bool ConfigManager::validateMiningConfig() const {
         valid = false;
     }
     
+    static const std::vector<std::string> algorithms = {"randomx", "rx/0", "randomwow", "rx/wow", "randomarq", "rx/arq"};
+    if (std::find(algorithms.begin(), algorithms.end(), m_miningConfig.algorithm) == algorithms.end()) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Algorithm must be rx/0, rx/wow or rx/arq (or randomx, randomwow, randomarq)");
+        valid = false;
+    }
+    
+    if (m_miningConfig.engine != "interpreter" && m_miningConfig.engine != "threaded" &&
+        m_miningConfig.engine != "jit") {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Engine must be interpreter, threaded or jit");
+        valid = false;
+    }
+    
+    if (m_miningConfig.batchSize < 1 || m_miningConfig.batchSize > 4) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Batch size must be between 1 and 4");
+        valid = false;
+    }
+    
+    if (m_miningConfig.prefetchDistance < 0 || m_miningConfig.prefetchDistance > 64) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Prefetch distance must be between 0 and 64");
+        valid = false;
+    }
+    
+    if (m_miningConfig.nonceReservedBytes < 0 || m_miningConfig.nonceReservedBytes > 3) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Reserved nonce bytes must be between 0 and 3");
+        valid = false;
+    }
+    
+    if (m_miningConfig.nonceInstances < 1 || m_miningConfig.nonceInstances > 256) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Nonce instances must be between 1 and 256");
+        valid = false;
+    } else if (m_miningConfig.nonceInstance < 0 || m_miningConfig.nonceInstance >= m_miningConfig.nonceInstances) {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Nonce instance must be below the number of nonce instances");
+        valid = false;
+    }
+    
+    if (m_miningConfig.memoryMode != "auto" && m_miningConfig.memoryMode != "fast" &&
+        m_miningConfig.memoryMode != "light") {
+        const_cast<std::vector<std::string>&>(m_validationErrors).push_back("Memory mode must be auto, fast or light");
+        valid = false;
+    }
+    
     return valid;
 }
 
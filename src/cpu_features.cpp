@@ -0,0 +1,117 @@
+#include "cpu_features.h"
+#include <cstdint>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_FEATURES_X86 1
+#include <cpuid.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+#if defined(CPU_FEATURES_X86)
+    CpuFeatureSet detectX86() {
+        CpuFeatureSet features;
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return features;
+        }
+        features.sse2 = edx & (1u << 26);
+        features.ssse3 = ecx & (1u << 9);
+        features.sse41 = ecx & (1u << 19);
+        features.aes = ecx & (1u << 25);
+        
+        // XCR0 bits 1-2 cover XMM/YMM, bits 5-7 the AVX-512 opmask and ZMM state
+        bool ymmState = false;
+        bool zmmState = false;
+        if ((ecx & (1u << 27)) != 0) {
+            uint32_t xcr0Low, xcr0High;
+            __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            ymmState = (xcr0Low & 0x06) == 0x06;
+            zmmState = (xcr0Low & 0xe6) == 0xe6;
+        }
+        features.avx = ymmState && (ecx & (1u << 28));
+        
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            features.avx2 = ymmState && (ebx & (1u << 5));
+            features.bmi2 = ebx & (1u << 8);
+            features.avx512f = zmmState && (ebx & (1u << 16));
+            features.avx512dq = features.avx512f && (ebx & (1u << 17));
+            features.avx512bw = features.avx512f && (ebx & (1u << 30));
+            features.vaes = features.avx512f && (ecx & (1u << 9));
+        }
+        return features;
+    }
+#endif
+}
+
+const CpuFeatureSet& CpuFeatures::detect() {
+    static const CpuFeatureSet features = [] {
+#if defined(CPU_FEATURES_X86)
+        return detectX86();
+#else
+        CpuFeatureSet detected;
+#if defined(__aarch64__)
+        detected.neon = true;
+#if defined(__APPLE__)
+        detected.aes = true;
+#elif defined(__linux__) && defined(HWCAP_AES)
+        detected.aes = (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#endif
+#endif
+        return detected;
+#endif
+    }();
+    return features;
+}
+
+CpuIsaLevel CpuFeatures::isaLevel() {
+    const CpuFeatureSet& features = detect();
+    if (features.neon) {
+        return CpuIsaLevel::NEON;
+    }
+    if (features.avx512f && features.avx512dq && features.avx512bw) {
+        return CpuIsaLevel::AVX512;
+    }
+    if (features.avx2 && features.bmi2) {
+        return CpuIsaLevel::AVX2;
+    }
+    if (features.sse41 && features.ssse3) {
+        return CpuIsaLevel::SSE41;
+    }
+    return CpuIsaLevel::GENERIC;
+}
+
+std::string CpuFeatures::isaLevelToString(CpuIsaLevel level) {
+    switch (level) {
+        case CpuIsaLevel::GENERIC: return "generic";
+        case CpuIsaLevel::SSE41: return "x86-64-v2 (SSE4.1)";
+        case CpuIsaLevel::AVX2: return "x86-64-v3 (AVX2)";
+        case CpuIsaLevel::AVX512: return "x86-64-v4 (AVX-512)";
+        case CpuIsaLevel::NEON: return "arm64 (NEON)";
+    }
+    return "unknown";
+}
+
+std::string CpuFeatures::featureString() {
+    const CpuFeatureSet& features = detect();
+    const std::pair<bool, const char*> flags[] = {
+        {features.sse2, "sse2"}, {features.ssse3, "ssse3"}, {features.sse41, "sse4.1"},
+        {features.avx, "avx"}, {features.avx2, "avx2"}, {features.bmi2, "bmi2"},
+        {features.avx512f, "avx512f"}, {features.avx512dq, "avx512dq"}, {features.avx512bw, "avx512bw"},
+        {features.aes, "aes"}, {features.vaes, "vaes"}, {features.neon, "neon"}
+    };
+    
+    std::string result;
+    for (const auto& [present, name] : flags) {
+        if (present) {
+            if (!result.empty()) {
+                result += ' ';
+            }
+            result += name;
+        }
+    }
+    return result.empty() ? "none" : result;
+}
@@ -0,0 +1,246 @@
+#include "cpu_topology.h"
+#include "logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <map>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+static std::string readFirstLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+std::vector<NumaNode> CpuTopology::detectNumaNodes() {
+    std::vector<NumaNode> nodes;
+
+#if defined(__linux__)
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+        
+        NumaNode node;
+        node.id = std::stoi(name.substr(4));
+        node.cpus = parseCpuList(readFirstLine((entry.path() / "cpulist").string()));
+        
+        // "Node 0 MemTotal:       32763716 kB"
+        std::ifstream meminfo(entry.path() / "meminfo");
+        std::string line;
+        while (std::getline(meminfo, line)) {
+            size_t pos = line.find("MemTotal:");
+            if (pos != std::string::npos) {
+                node.memoryBytes = std::stoull(line.substr(pos + 9)) * 1024;
+                break;
+            }
+        }
+        
+        // Memory-only nodes have no threads to serve
+        if (!node.cpus.empty()) {
+            nodes.push_back(node);
+        }
+    }
+    
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+    
+    if (nodes.empty()) {
+        NumaNode node;
+        unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < threads; cpu++) {
+            node.cpus.push_back(static_cast<int>(cpu));
+        }
+        nodes.push_back(node);
+    }
+    
+    return nodes;
+}
+
+static std::vector<int> onlineCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpus = CpuTopology::parseCpuList(readFirstLine("/sys/devices/system/cpu/online"));
+#endif
+    if (cpus.empty()) {
+        unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < threads; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+// sysfs cache sizes read "48K", "2048K" or "32M"
+static size_t parseCacheSize(const std::string& text) {
+    try {
+        size_t end = 0;
+        size_t value = std::stoull(text, &end);
+        if (end < text.size()) {
+            char unit = static_cast<char>(std::toupper(static_cast<unsigned char>(text[end])));
+            if (unit == 'K') value *= 1024;
+            if (unit == 'M') value *= 1024 * 1024;
+            if (unit == 'G') value *= 1024 * 1024 * 1024;
+        }
+        return value;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+std::vector<CpuCore> CpuTopology::detectCores() {
+    std::map<std::pair<int, int>, CpuCore> cores;
+    
+    for (int cpu : onlineCpus()) {
+        CpuCore core;
+        core.id = cpu;
+#if defined(__linux__)
+        const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        try {
+            core.package = std::stoi(readFirstLine(topology + "physical_package_id"));
+            core.id = std::stoi(readFirstLine(topology + "core_id"));
+        } catch (const std::exception&) {
+            // No topology directory: treat the CPU as its own core
+        }
+#endif
+        CpuCore& entry = cores[{core.package, core.id}];
+        entry.package = core.package;
+        entry.id = core.id;
+        entry.threads.push_back(cpu);
+    }
+    
+    std::vector<CpuCore> result;
+    for (auto& [key, core] : cores) {
+        std::sort(core.threads.begin(), core.threads.end());
+        result.push_back(core);
+    }
+    return result;
+}
+
+std::vector<CpuCache> CpuTopology::detectCaches(int level) {
+    std::vector<CpuCache> caches;
+    
+#if defined(__linux__)
+    std::map<std::string, CpuCache> unique;
+    for (int cpu : onlineCpus()) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/";
+        for (int index = 0; index < 8; index++) {
+            const std::string dir = base + "index" + std::to_string(index) + "/";
+            std::string levelText = readFirstLine(dir + "level");
+            if (levelText.empty()) {
+                break;
+            }
+            if (levelText != std::to_string(level) || readFirstLine(dir + "type") == "Instruction") {
+                continue;
+            }
+            
+            // CPUs sharing an instance list the same shared_cpu_list
+            std::string shared = readFirstLine(dir + "shared_cpu_list");
+            CpuCache& cache = unique[shared];
+            cache.level = level;
+            cache.sizeBytes = parseCacheSize(readFirstLine(dir + "size"));
+            cache.cpus = parseCpuList(shared);
+        }
+    }
+    for (auto& [shared, cache] : unique) {
+        caches.push_back(cache);
+    }
+#elif defined(__APPLE__)
+    // One system-wide figure per level; Apple Silicon reports no L3
+    int64_t size = 0;
+    size_t length = sizeof(size);
+    const char* name = level == 2 ? "hw.l2cachesize" : "hw.l3cachesize";
+    if (sysctlbyname(name, &size, &length, nullptr, 0) == 0 && size > 0) {
+        CpuCache cache;
+        cache.level = level;
+        cache.sizeBytes = static_cast<size_t>(size);
+        cache.cpus = onlineCpus();
+        caches.push_back(cache);
+    }
+#endif
+    
+    std::sort(caches.begin(), caches.end(), [](const CpuCache& a, const CpuCache& b) {
+        return a.cpus.empty() || (!b.cpus.empty() && a.cpus.front() < b.cpus.front());
+    });
+    return caches;
+}
+
+std::string CpuTopology::formatCpuList(const std::vector<int>& cpus) {
+    std::string list;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        size_t last = i;
+        while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) {
+            last++;
+        }
+        if (!list.empty()) {
+            list += ",";
+        }
+        list += std::to_string(cpus[i]);
+        if (last > i) {
+            list += "-" + std::to_string(cpus[last]);
+        }
+        i = last;
+    }
+    return list;
+}
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    
+    while (std::getline(stream, range, ',')) {
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Empty or malformed entries (e.g. a trailing newline) are skipped
+        }
+    }
+    
+    return cpus;
+}
+
+bool CpuTopology::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        LOG_WARNING("Failed to pin thread to {} CPU(s): error {}", cpus.size(), result);
+        return false;
+    }
+    return true;
+#else
+    // macOS only offers affinity hints, not binding
+    return false;
+#endif
+}
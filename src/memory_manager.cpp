@@ -5,11 +5,16 @@
 #include <random>
 #include <cstring>
 #include <functional>
+#include <fstream>
 #include <sys/sysctl.h>
 #include <mach/mach.h>
 #include <mach/vm_statistics.h>
 #include <mach/mach_host.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 // Global memory manager instance
 std::unique_ptr<RandomXMemoryManager> g_memoryManager = nullptr;
 
@@ -732,6 +737,27 @@ namespace MemoryUtils {
         return 0;
     }
     
+    size_t getProcessResidentMemory() {
+#if defined(__APPLE__)
+        mach_task_basic_info_data_t info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                      reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+            return info.resident_size;
+        }
+        return 0;
+#else
+        // Second field of /proc/self/statm is resident pages
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0;
+        size_t residentPages = 0;
+        if (statm >> totalPages >> residentPages) {
+            return residentPages * getpagesize();
+        }
+        return 0;
+#endif
+    }
+    
     size_t getCPUCount() {
         return std::thread::hardware_concurrency();
     }
@@ -759,8 +785,24 @@ namespace MemoryUtils {
     }
     
     void prefetchMemory(void* ptr, size_t size) {
-        // Prefetch memory for better performance
-        __builtin_prefetch(ptr, 0, 3); // Read, temporal locality
+        // Prefetch every cache line of the range for reading into all cache levels.
+        // 64-byte steps cover both x86 lines and Apple Silicon's 128-byte lines.
+        constexpr size_t prefetchStride = 64;
+        if (!ptr) {
+            return;
+        }
+        
+        const char* begin = static_cast<const char*>(ptr);
+        const char* end = begin + std::max<size_t>(size, 1);
+        for (const char* line = begin; line < end; line += prefetchStride) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(line, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(line, _MM_HINT_T0);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+            __prefetch(line);
+#endif
+        }
     }
     
     void flushMemory(void* ptr, size_t size) {
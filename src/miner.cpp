@@ -5,22 +5,34 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <algorithm>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <netdb.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/sysctl.h>
 #include <mach/mach.h>
 
 #include "randomx.h"
+#include "thread_tuner.h"
 
-Miner::Miner() : m_running(false), m_connected(false), m_initialized(false), m_socket(-1), m_ssl(nullptr), m_sslContext(nullptr), m_idleTime(0), m_miningActive(false), m_sharesSubmitted(0), m_sharesAccepted(0), m_sharesRejected(0), m_submitId(1) {
+// The logger only substitutes plain {}, so fixed-point figures are formatted first
+static std::string formatFixed(double value, int precision = 2) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(precision) << value;
+    return text.str();
+}
+
+Miner::Miner() : m_running(false), m_connected(false), m_initialized(false), m_job(nullptr), m_jobGeneration(0),
+                 m_jobEpochCount(0), m_jobSwitchState(0), m_activeMiners(0), m_socket(-1), m_ssl(nullptr), m_sslContext(nullptr), m_idleTime(0), m_miningActive(false), m_tunedThreads(0), m_sharesSubmitted(0), m_sharesAccepted(0), m_sharesRejected(0), m_sharesStale(0), m_submitId(MINING_FIRST_SUBMIT_ID) {
     m_performanceMonitor = std::make_unique<PerformanceMonitor>();
 }
 
@@ -29,6 +41,7 @@ Miner::~Miner() {
     if (m_socket != -1) {
         close(m_socket);
     }
+    delete m_job.exchange(nullptr);
 }
 
 bool Miner::initialize(const ConfigManager& config) {
@@ -67,17 +80,59 @@ bool Miner::initializeRandomX() {
     LOG_INFO("Initializing RandomX algorithm");
     
     m_randomx = std::make_unique<RandomX>();
-    // Initialize RandomX with a default key for now
+    // Initialize RandomX with a default key for now, one VM per mining thread
     uint8_t defaultKey[32] = {0};
-    if (!m_randomx->initialize(defaultKey, sizeof(defaultKey))) {
+    RandomXVariant variant = RandomXVariant::RX_0;
+    RandomX::variantFromString(m_config.getMiningConfig().algorithm, variant);
+    m_randomx->setVariant(variant);
+    m_randomx->setEngine(RandomX::engineFromString(m_config.getMiningConfig().engine));
+    m_randomx->setBatchSize(m_config.getMiningConfig().batchSize);
+    m_randomx->setPrefetchDistance(static_cast<uint32_t>(m_config.getMiningConfig().prefetchDistance));
+    m_randomx->setDatasetCacheDir(m_config.getMiningConfig().datasetCacheDir);
+    m_randomx->setUseHugePages(m_config.getMiningConfig().useHugePages);
+    m_randomx->setNumaEnabled(m_config.getMiningConfig().numa);
+    MemoryMode memoryMode = RandomX::memoryModeFromString(m_config.getMiningConfig().memoryMode);
+    if (!m_randomx->initialize(defaultKey, sizeof(defaultKey), memoryMode, m_config.getMiningConfig().threads)) {
         LOG_ERROR("Failed to initialize RandomX");
         return false;
     }
+    m_seedHash = RandomX::bytesToHex(defaultKey, sizeof(defaultKey));
+    m_algo = RandomX::variantToString(variant);
     
-    LOG_INFO("RandomX initialized successfully");
+    LOG_INFO("RandomX initialized successfully ({}, {} mode, {} pages, {} engine, batch size {}, prefetch distance {})",
+             m_algo, RandomX::memoryModeToString(m_randomx->getMemoryMode()),
+             RandomXMemory::pagesToString(m_randomx->getDatasetPages()),
+             RandomX::engineToString(m_randomx->getEngine()), m_randomx->getBatchSize(),
+             m_randomx->getPrefetchDistance());
+    
+    if (m_config.getMiningConfig().threads == 0 && m_config.getMiningConfig().autoTune) {
+        tuneThreads();
+    }
     return true;
 }
 
+void Miner::tuneThreads() {
+    const std::string& path = m_config.getMiningConfig().tuningFile;
+    const std::string fingerprint = ThreadTuner::fingerprint(*m_randomx);
+    
+    ThreadPlan plan;
+    if (!path.empty() && ThreadTuner::load(path, fingerprint, plan) && plan.threads <= m_randomx->getWorkerCount()) {
+        m_randomx->setWorkerCpus(plan.cpus);
+    } else {
+        ThreadPlan proposal = ThreadTuner::propose();
+        LOG_INFO("Thread tuner proposes {} threads on CPUs {} ({})", proposal.threads,
+                 CpuTopology::formatCpuList(proposal.cpus), proposal.reason);
+        plan = ThreadTuner::calibrate(*m_randomx, proposal);
+        if (!path.empty() && ThreadTuner::save(path, fingerprint, plan)) {
+            LOG_INFO("Thread tuning saved to {}", path);
+        }
+    }
+    
+    m_tunedThreads = plan.threads;
+    LOG_INFO("Mining with {} threads on CPUs {} ({}, {} H/s calibrated)", plan.threads,
+             CpuTopology::formatCpuList(plan.cpus), plan.reason, formatFixed(plan.hashRate));
+}
+
 bool Miner::connectToPool() {
     LOG_INFO("Connecting to mining pool: {}", m_config.getPoolConfig().url);
     
@@ -92,8 +147,8 @@ bool Miner::connectToPool() {
     }
     
     // Create socket
-    m_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (m_socket == -1) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) {
         LOG_ERROR("Failed to create socket: {}", strerror(errno));
         return false;
     }
@@ -102,6 +157,7 @@ bool Miner::connectToPool() {
     struct hostent* he = gethostbyname(host.c_str());
     if (!he) {
         LOG_ERROR("Failed to resolve hostname: {}", host);
+        close(fd);
         return false;
     }
     
@@ -111,11 +167,19 @@ bool Miner::connectToPool() {
     addr.sin_port = htons(port);
     addr.sin_addr = *((struct in_addr*)he->h_addr);
     
-    if (connect(m_socket, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
         LOG_ERROR("Failed to connect to pool {}:{} - {}", host, port, strerror(errno));
+        close(fd);
         return false;
     }
     
+    // The submission thread reads m_socket under m_sendMutex; it stays idle until
+    // m_connected is set after the login handshake below
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_socket = fd;
+    }
+    
     LOG_INFO("Connected to pool {}:{}", host, port);
         
     // Note: SSL support removed for simplicity
@@ -135,13 +199,16 @@ bool Miner::connectToPool() {
 }
 
 bool Miner::reconnectToPool() {
-    // Close existing connection
-    if (m_socket != -1) {
-        close(m_socket);
-        m_socket = -1;
-    }
-    
+    // Stop share submission first, then close under the send lock so no submit is
+    // in flight on the old socket
     m_connected = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        if (m_socket != -1) {
+            close(m_socket);
+            m_socket = -1;
+        }
+    }
     
     // Wait a bit before reconnecting
     std::this_thread::sleep_for(std::chrono::seconds(2));
@@ -302,6 +369,11 @@ bool Miner::sendLogin() {
 }
 
 bool Miner::sendData(const std::string& data) {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    return sendDataLocked(data);
+}
+
+bool Miner::sendDataLocked(const std::string& data) {
     int result = send(m_socket, data.c_str(), data.length(), 0);
     if (result <= 0) {
         LOG_ERROR("Failed to send data: {}", strerror(errno));
@@ -343,6 +415,13 @@ void Miner::start() {
     
     // Start communication thread
     m_communicationThread = std::thread(&Miner::communicationLoop, this);
+    
+    // Start seed switching thread
+    m_seedThread = std::thread(&Miner::seedLoop, this);
+    
+    // Start share submission thread
+    m_shareQueue.open();
+    m_submitThread = std::thread(&Miner::submitLoop, this);
 }
 
 void Miner::stop() {
@@ -376,140 +455,344 @@ void Miner::stop() {
         m_communicationThread.join();
     }
     
+    // Wait for seed thread
+    if (m_seedThread.joinable()) {
+        m_seedThread.join();
+    }
+    
+    // Wait for share submission thread; it sends what the mining threads left queued
+    m_shareQueue.close();
+    if (m_submitThread.joinable()) {
+        m_submitThread.join();
+    }
+    
     LOG_INFO("Miner stopped");
 }
 
 void Miner::miningLoop(int threadId) {
-    LOG_INFO("Mining thread {} started", threadId);
+    // Each mining thread owns a RandomX VM for its whole lifetime
+    int workerId = m_randomx->acquireWorker();
+    if (workerId < 0) {
+        LOG_ERROR("Mining thread {} could not acquire a RandomX worker", threadId);
+        return;
+    }
     
+    if (m_randomx->bindThreadToWorker(workerId)) {
+        LOG_INFO("Mining thread {} started (worker {}, NUMA node {})", threadId, workerId,
+                 m_randomx->getWorkerNumaNode(workerId));
+    } else {
+        LOG_INFO("Mining thread {} started (worker {})", threadId, workerId);
+    }
+    
+    MiningLanes lanes;
+    m_activeMiners++;
     while (m_running && m_miningActive) {
-        if (!m_currentJob.isValid) {
+        // One load per batch: the lanes of a batch finish together, so a new job waits
+        // for at most mining.batchSize hashes in flight (one lockstep pass)
+        if (m_jobGeneration.load(std::memory_order_acquire) != lanes.generation) {
+            adoptJob(threadId, lanes);
+        }
+        if (!lanes.job || !lanes.job->isValid) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             continue;
         }
         
         // Mine the current job
-        mineJob(threadId);
+        mineJob(threadId, workerId, lanes);
     }
     
+    m_activeMiners--;
+    if (static_cast<size_t>(threadId) < m_jobEpochCount) {
+        m_jobEpochs[threadId].generation.store(JOB_EPOCH_IDLE, std::memory_order_release);
+    }
+    m_randomx->releaseWorker(workerId);
     LOG_INFO("Mining thread {} stopped", threadId);
 }
 
-void Miner::mineJob(int threadId) {
+void Miner::mineJob(int threadId, int workerId, MiningLanes& lanes) {
     try {
-        // Convert job blob from hex to bytes
-        std::vector<uint8_t> blob = RandomX::hexToBytes(m_currentJob.blob);
-        if (blob.empty()) {
-            LOG_ERROR("Invalid job blob: {}", m_currentJob.blob);
-            return;
-        }
+        const MiningJob& job = *lanes.job;
+        const size_t batchSize = m_randomx->getBatchSize();
+        const size_t blobSize = job.blobSize;
         
-        // For Monero, we need to insert the nonce into the blob
-        // The nonce goes in bytes 39-42 of the blob
-        if (blob.size() < 43) {
-            LOG_ERROR("Blob too small: {} bytes", blob.size());
-            return;
+        // Claim the next chunk of the job's nonces once this thread's chunk is used up
+        if (lanes.range.count == 0) {
+            uint32_t chunk = NonceAllocator::chunkSize(lanes.hashRate, static_cast<uint32_t>(batchSize));
+            if (!job.nonces || !job.nonces->claim(chunk, lanes.range)) {
+                if (!lanes.exhausted) {
+                    LOG_WARNING("Nonce space of job {} is used up, thread {} waits for a new job", job.jobId, threadId);
+                    lanes.exhausted = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                return;
+            }
         }
         
-        // Create nonce
-        uint32_t nonce = m_currentJob.nonce + threadId;
-        
-        // Insert nonce into blob (little-endian)
-        blob[39] = nonce & 0xFF;
-        blob[40] = (nonce >> 8) & 0xFF;
-        blob[41] = (nonce >> 16) & 0xFF;
-        blob[42] = (nonce >> 24) & 0xFF;
+        // Each pass hashes the next consecutive nonces of the chunk, one per batch lane
+        const uint32_t firstNonce = lanes.range.first;
+        const size_t count = std::min<size_t>(batchSize, lanes.range.count);
+        for (size_t lane = 0; lane < count; lane++) {
+            uint32_t nonce = firstNonce + static_cast<uint32_t>(lane);
+            uint8_t* nonceBytes = lanes.blobs.data() + lane * blobSize + job.nonceOffset;
+            nonceBytes[0] = nonce & 0xFF;
+            nonceBytes[1] = (nonce >> 8) & 0xFF;
+            nonceBytes[2] = (nonce >> 16) & 0xFF;
+            nonceBytes[3] = (nonce >> 24) & 0xFF;
+        }
         
-        // Hash the job
-        uint8_t hash[32];
-        m_randomx->calculateHash(blob.data(), blob.size(), hash);
+        // Hash the batch in lockstep, timing it for the next chunk size
+        auto start = std::chrono::steady_clock::now();
+        m_randomx->calculateHashBatch(workerId, lanes.blobs.data(), blobSize, count, lanes.hashes.data());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds > 0.0) {
+            double rate = count / seconds;
+            lanes.hashRate = lanes.hashRate > 0.0 ? 0.8 * lanes.hashRate + 0.2 * rate : rate;
+        }
+        lanes.range.first += static_cast<uint32_t>(count);
+        lanes.range.count -= static_cast<uint32_t>(count);
         
-        // Check if hash meets target
-        if (isValidShare(hash, m_currentJob.target)) {
-            LOG_INFO("Valid share found by thread {}: nonce={}", threadId, nonce);
-            submitShare(nonce, hash);
+        // Check if hashes meet target
+        const uint64_t target64 = job.target64;
+        for (size_t lane = 0; lane < count; lane++) {
+            const uint8_t* hash = lanes.hashes.data() + lane * RANDOMX_HASH_SIZE;
+            uint32_t nonce = firstNonce + static_cast<uint32_t>(lane);
+            if (isValidShare(hash, target64)) {
+                LOG_INFO("Valid share found by thread {}: nonce={}", threadId, nonce);
+                submitShare(job, nonce, hash);
+            }
         }
         
         // Update performance stats
         updatePerformanceStats();
-        
-        // Update nonce for next iteration
-        m_currentJob.nonce += m_miningThreads.size();
     } catch (const std::exception& e) {
         LOG_ERROR("Exception in mining loop: {}", e.what());
     }
 }
 
-bool Miner::isValidShare(const uint8_t* hash, const std::string& target) {
-    try {
-        // Convert target from hex to bytes
-        std::vector<uint8_t> targetBytes = RandomX::hexToBytes(target);
-        if (targetBytes.size() != 32) {
-            LOG_ERROR("Invalid target size: {} (expected 32)", targetBytes.size());
+bool Miner::isValidShare(const uint8_t* hash, uint64_t target64) {
+    if (!meetsTarget(hash, target64)) {
+        return false;
+    }
+    
+    std::ostringstream target;
+    target << std::hex << std::setw(16) << std::setfill('0') << target64;
+    LOG_DEBUG("Valid share found! Hash: {}... Target: {}", RandomX::bytesToHex(hash + 24, 8), target.str());
+    return true;
+}
+
+// The hash is a little-endian 256-bit number; pool difficulty never reaches
+// below its top 64 bits, so one compare of bytes 24-31 decides the share
+bool Miner::meetsTarget(const uint8_t* hash, uint64_t target64) {
+    uint64_t value = 0;
+    for (int i = 31; i >= 24; i--) {
+        value = (value << 8) | hash[i];
+    }
+    return value < target64;
+}
+
+bool Miner::decodeJob(MiningJob& job) {
+    std::vector<uint8_t> blob = RandomX::hexToBytes(job.blob);
+    if (blob.size() * 2 != job.blob.size() || blob.size() < MINING_NONCE_OFFSET + 4 ||
+        blob.size() > MINING_MAX_BLOB_SIZE) {
+        LOG_ERROR("Invalid job blob ({} hex characters)", job.blob.size());
+        return false;
+    }
+    std::memcpy(job.blobBytes.data(), blob.data(), blob.size());
+    job.blobSize = blob.size();
+    job.nonceOffset = MINING_NONCE_OFFSET;
+    
+    std::vector<uint8_t> target = RandomX::hexToBytes(job.target);
+    if (target.size() * 2 != job.target.size()) {
+        LOG_ERROR("Invalid job target: {}", job.target);
+        return false;
+    }
+    uint64_t value = 0;
+    switch (target.size()) {
+        case 4:
+        case 8:
+            for (size_t i = target.size(); i-- > 0;) {
+                value = (value << 8) | target[i];
+            }
+            break;
+        case 32:
+            for (size_t i = 32; i-- > 24;) {
+                value = (value << 8) | target[i];
+            }
+            break;
+        default:
+            LOG_ERROR("Invalid job target size: {} bytes (expected 4, 8 or 32)", target.size());
+            return false;
+    }
+    
+    // Compact targets bound the top 32 bits; scale them to 64 the way pools derive them
+    if (target.size() == 4) {
+        if (value == 0) {
+            LOG_ERROR("Invalid job target: {}", job.target);
             return false;
         }
-        
-        // Validate share against target (little-endian comparison)
-        bool isValid = true;
-        for (int i = 31; i >= 0; i--) {
-            if (hash[i] < targetBytes[i]) {
-                // Hash is less than target - valid share
-                break;
-            } else if (hash[i] > targetBytes[i]) {
-                // Hash is greater than target - invalid share
-                isValid = false;
+        value = 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / value);
+    }
+    job.target64 = value;
+    return true;
+}
+
+// Runs on the mining thread: hand the share to the submission thread and return
+void Miner::submitShare(const MiningJob& job, uint32_t nonce, const uint8_t* hash) {
+    if (!job.isValid) {
+        LOG_WARNING("Cannot submit share - no valid job");
+        return;
+    }
+    if (dropStaleShare(job.generation, nonce)) {
+        return;
+    }
+    
+    auto share = std::make_unique<FoundShare>();
+    share->jobId = job.jobId;
+    share->jobGeneration = job.generation;
+    share->nonce = nonce;
+    std::memcpy(share->hash.data(), hash, share->hash.size());
+    share->foundAt = std::chrono::steady_clock::now();
+    m_shareQueue.push(std::move(share));
+}
+
+void Miner::submitLoop() {
+    LOG_INFO("Share submission thread started");
+    
+    while (true) {
+        // Shares wait in the queue while the pool is down or still logging in;
+        // the stale check drops them if the reconnect brings a new job
+        if (!m_connected) {
+            if (m_shareQueue.isClosed()) {
                 break;
             }
-            // If equal, continue checking next byte
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
         }
         
-        if (isValid) {
-            m_sharesSubmitted++;
-            LOG_DEBUG("Valid share found! Hash: {}... Target: {}...", 
-                     RandomX::bytesToHex(hash, 8), target.substr(0, 16));
+        std::unique_ptr<FoundShare> share = m_shareQueue.pop();
+        if (share) {
+            if (!sendShare(*share)) {
+                m_shareQueue.push(std::move(share));
+            }
+        } else if (m_shareQueue.isClosed()) {
+            break;
+        } else {
+            m_shareQueue.wait();
         }
-        
-        return isValid;
-    } catch (const std::exception& e) {
-        LOG_ERROR("Exception in isValidShare: {}", e.what());
+    }
+    
+    LOG_INFO("Share submission thread stopped");
+}
+
+// A share for a job the pool has since replaced would only come back rejected, so
+// it is counted as stale instead of sent; checked when found and again before sending
+bool Miner::dropStaleShare(uint64_t jobGeneration, uint32_t nonce) {
+    if (jobGeneration >= m_jobGeneration.load(std::memory_order_acquire)) {
         return false;
     }
+    
+    m_sharesStale++;
+    LOG_INFO("Dropped stale share: nonce={}, job generation {} replaced, {} stale so far",
+             nonce, jobGeneration, m_sharesStale.load());
+    return true;
 }
 
-void Miner::submitShare(uint32_t nonce, const uint8_t* hash) {
-    if (!m_currentJob.isValid) {
-        LOG_WARNING("Cannot submit share - no valid job");
-        return;
+// False when the pool is not logged in, so the caller can hold the share
+bool Miner::sendShare(const FoundShare& share) {
+    if (dropStaleShare(share.jobGeneration, share.nonce)) {
+        return true;
+    }
+    
+    // Held from the login check to the send: a reconnect cannot close the socket
+    // or start its handshake in between
+    std::lock_guard<std::mutex> sendLock(m_sendMutex);
+    if (!m_connected) {
+        return false;
     }
     
     // Convert hash to hex
-    std::string hashHex = RandomX::bytesToHex(hash, 32);
+    std::string hashHex = RandomX::bytesToHex(share.hash.data(), share.hash.size());
+    const uint32_t id = m_submitId++;
     
     // Create submit request in Stratum format
     std::ostringstream json;
-    json << "{\"id\":" << (m_submitId++) << ",\"jsonrpc\":\"2.0\",\"method\":\"mining.submit\",\"params\":[";
+    json << "{\"id\":" << id << ",\"jsonrpc\":\"2.0\",\"method\":\"mining.submit\",\"params\":[";
     json << "\"" << m_config.getPoolConfig().username << "\",";
-    json << "\"" << m_currentJob.jobId << "\",";
-    json << "\"" << std::hex << nonce << "\",";
+    json << "\"" << share.jobId << "\",";
+    json << "\"" << std::hex << share.nonce << "\",";
     json << "\"" << hashHex << "\"";
     json << "]}";
     
     std::string request = json.str();
-    LOG_INFO("Submitting share: nonce={}, hash={}...", nonce, hashHex.substr(0, 16));
+    LOG_INFO("Submitting share: nonce={}, hash={}..., id={}", share.nonce, hashHex.substr(0, 16), id);
     
-    if (sendData(request + "\n")) {
-        // Wait for response
-        std::string response;
-        if (receiveData(response)) {
-            processShareResponse(response, nonce);
-        } else {
-            LOG_ERROR("Failed to receive share response");
-            m_sharesRejected++;
-        }
-    } else {
+    // Filed before sending so the answer cannot arrive ahead of its entry
+    expirePendingShares(false);
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingShares[id] = PendingShare{share.nonce, share.jobId, std::chrono::steady_clock::now()};
+    }
+    m_sharesSubmitted++;
+    
+    if (!sendDataLocked(request + "\n")) {
         LOG_ERROR("Failed to submit share");
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingShares.erase(id);
         m_sharesRejected++;
     }
+    return true;
+}
+
+// Match a pool response to a submitted share by its id (false if it is not one)
+bool Miner::completeShare(const std::string& response) {
+    uint64_t id = 0;
+    if (!extractJsonId(response, id)) {
+        return false;
+    }
+    
+    PendingShare pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pendingShares.find(id);
+        if (it == m_pendingShares.end()) {
+            return false;
+        }
+        pending = std::move(it->second);
+        m_pendingShares.erase(it);
+    }
+    
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - pending.sentAt).count();
+    if (m_performanceMonitor) {
+        m_performanceMonitor->recordShareLatency(milliseconds);
+    }
+    LOG_DEBUG("Share {} for job {} answered in {} ms", id, pending.jobId, formatFixed(milliseconds));
+    processShareResponse(response, pending.nonce);
+    return true;
+}
+
+// Shares the pool never answered count as rejected: after the pool timeout (checked
+// on every share sent and every communicationLoop wakeup), or all of them when the
+// connection drops
+void Miner::expirePendingShares(bool all) {
+    const auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(m_config.getPoolConfig().timeout);
+    size_t expired = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (auto it = m_pendingShares.begin(); it != m_pendingShares.end();) {
+            if (all || it->second.sentAt < deadline) {
+                it = m_pendingShares.erase(it);
+                expired++;
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    if (expired > 0) {
+        m_sharesRejected += expired;
+        LOG_WARNING("{} submitted share(s) got no answer from the pool", expired);
+    }
 }
 
 void Miner::processShareResponse(const std::string& response, uint32_t nonce) {
@@ -540,8 +823,9 @@ void Miner::processShareResponse(const std::string& response, uint32_t nonce) {
     uint64_t total = m_sharesAccepted.load() + m_sharesRejected.load();
     if (total > 0) {
         double acceptanceRate = (double)m_sharesAccepted.load() / total * 100.0;
-        LOG_INFO("Mining stats: {} submitted, {} accepted, {} rejected ({}% acceptance rate)", 
-                m_sharesSubmitted.load(), m_sharesAccepted.load(), m_sharesRejected.load(), acceptanceRate);
+        LOG_INFO("Mining stats: {} submitted, {} accepted, {} rejected ({}% acceptance rate), {} stale dropped", 
+                m_sharesSubmitted.load(), m_sharesAccepted.load(), m_sharesRejected.load(), acceptanceRate,
+                m_sharesStale.load());
     }
 }
 
@@ -550,21 +834,101 @@ void Miner::updatePerformanceStats() {
         // Update hash rate
         double hashRate = m_randomx ? m_randomx->getHashRate() : 0.0;
         m_performanceMonitor->updateHashRate(hashRate);
+        if (m_randomx) {
+            m_performanceMonitor->updateNodeHashRates(m_randomx->getNodeHashRates());
+        }
         
         // Update shares
         m_performanceMonitor->updateShares(
             m_sharesSubmitted.load(),
             m_sharesAccepted.load(),
-            m_sharesRejected.load()
+            m_sharesRejected.load(),
+            m_sharesStale.load()
         );
-        
-        // Update job info
-        if (m_currentJob.isValid) {
-            m_performanceMonitor->updateJobInfo(
-                m_currentJob.jobId,
-                m_config.getPoolConfig().url,
-                1.0 // Placeholder difficulty
-            );
+    }
+}
+
+void Miner::publishJob(const MiningJob& job) {
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    
+    // The pointer is swapped before the generation moves, so a thread that sees a
+    // generation always loads that job or a newer one
+    auto next = std::make_unique<MiningJob>(job);
+    next->generation = m_jobGeneration.load(std::memory_order_relaxed) + 1;
+    const uint64_t generation = next->generation;
+    const MiningJob* previous = m_job.exchange(next.release(), std::memory_order_seq_cst);
+    m_jobGeneration.store(generation, std::memory_order_release);
+    
+    if (previous) {
+        m_retiredJobs.emplace_back(previous);
+    }
+    reclaimJobs();
+    
+    if (m_performanceMonitor) {
+        double difficulty = job.target64 ? static_cast<double>(UINT64_MAX) / job.target64 : 0.0;
+        m_performanceMonitor->updateJobInfo(job.jobId, m_config.getPoolConfig().url, difficulty);
+    }
+}
+
+// A retired job is freed once no mining thread's epoch is at or below its generation
+void Miner::reclaimJobs() {
+    uint64_t oldest = JOB_EPOCH_IDLE;
+    for (size_t i = 0; i < m_jobEpochCount; i++) {
+        oldest = std::min(oldest, m_jobEpochs[i].generation.load(std::memory_order_seq_cst));
+    }
+    m_retiredJobs.erase(std::remove_if(m_retiredJobs.begin(), m_retiredJobs.end(),
+                                       [oldest](const std::unique_ptr<const MiningJob>& retired) {
+                                           return retired->generation < oldest;
+                                       }),
+                        m_retiredJobs.end());
+}
+
+void Miner::adoptJob(int threadId, MiningLanes& lanes) {
+    // Announce the generation before loading the job, so the publisher cannot free
+    // what this thread is about to read
+    JobEpoch* epoch = static_cast<size_t>(threadId) < m_jobEpochCount ? &m_jobEpochs[threadId] : nullptr;
+    if (epoch) {
+        epoch->generation.store(m_jobGeneration.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    }
+    const MiningJob* job = m_job.load(std::memory_order_seq_cst);
+    if (!job) {
+        return;
+    }
+    if (epoch) {
+        epoch->generation.store(job->generation, std::memory_order_release);
+    }
+    lanes.job = job;
+    lanes.generation = job->generation;
+    
+    // Work left from the previous job is dropped. The decoded blob is copied into
+    // the lanes once; after that only the nonce bytes change between batches.
+    const size_t batchSize = m_randomx->getBatchSize();
+    lanes.blobs.resize(job->blobSize * batchSize);
+    lanes.hashes.resize(RANDOMX_HASH_SIZE * batchSize);
+    for (size_t lane = 0; lane < batchSize; lane++) {
+        std::memcpy(lanes.blobs.data() + lane * job->blobSize, job->blobBytes.data(), job->blobSize);
+    }
+    lanes.range = NonceRange();
+    lanes.exhausted = false;
+    
+    // The last mining thread onto this generation records the switch latency
+    uint64_t state = m_jobSwitchState.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint64_t stateGeneration = state >> 16;
+        if (stateGeneration > job->generation) {
+            return;
+        }
+        const uint64_t next = stateGeneration == job->generation ? state + 1 : (job->generation << 16) | 1;
+        if (m_jobSwitchState.compare_exchange_weak(state, next, std::memory_order_acq_rel)) {
+            if (static_cast<int>(next & 0xFFFF) == m_activeMiners.load(std::memory_order_relaxed)) {
+                double milliseconds = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - job->received).count();
+                if (m_performanceMonitor) {
+                    m_performanceMonitor->recordJobSwitch(milliseconds);
+                }
+                LOG_DEBUG("All mining threads on job {} {} ms after its notify", job->jobId, formatFixed(milliseconds));
+            }
+            return;
         }
     }
 }
@@ -573,11 +937,33 @@ void Miner::communicationLoop() {
     LOG_INFO("Communication thread started");
     
     while (m_running) {
+        // Wake at least once per poll interval so unanswered shares expire on time
+        // and stop() is noticed even when the pool is quiet
+        if (m_socket >= 0) {
+            struct pollfd descriptor = {m_socket, POLLIN, 0};
+            int ready = poll(&descriptor, 1, MINING_RECEIVE_POLL_MS);
+            expirePendingShares(false);
+            if (ready == 0 || (ready < 0 && errno == EINTR)) {
+                continue;
+            }
+        }
+        
         std::string response;
         if (receiveData(response)) {
-            processPoolMessage(response);
+            // Stratum messages are newline-terminated; one recv can hold several or part of one
+            m_receiveBuffer += response;
+            size_t end;
+            while ((end = m_receiveBuffer.find('\n')) != std::string::npos) {
+                std::string message = m_receiveBuffer.substr(0, end);
+                m_receiveBuffer.erase(0, end + 1);
+                if (!message.empty()) {
+                    processPoolMessage(message);
+                }
+            }
         } else {
-            // Connection lost, try to reconnect
+            // Connection lost, try to reconnect; answers to shares in flight are lost with it
+            m_receiveBuffer.clear();
+            expirePendingShares(true);
             LOG_WARNING("Connection lost, attempting to reconnect...");
             if (reconnectToPool()) {
                 LOG_INFO("Reconnected to pool successfully");
@@ -626,20 +1012,50 @@ void Miner::processPoolMessage(const std::string& message) {
                     pos = nextPos + 1;
                 }
                 
-                // Monero job format: [job_id, blob, target, algo, height, seed_hash]
+                // Monero job format: [job_id, blob, target, algo, height, seed_hash, next_seed_hash]
                 if (paramList.size() >= 3) {
-                    m_currentJob.jobId = paramList[0];
-                    m_currentJob.blob = paramList[1];
-                    m_currentJob.target = paramList[2];
-                    m_currentJob.nonce = 0;
-                    m_currentJob.isValid = true;
+                    MiningJob job;
+                    job.jobId = paramList[0];
+                    job.blob = paramList[1];
+                    job.target = paramList[2];
+                    job.seedHash = paramList.size() > 5 ? paramList[5] : "";
+                    job.received = std::chrono::steady_clock::now();
+                    
+                    // The pool's algo picks the RandomX variant; without one the configured variant is used
+                    RandomXVariant variant = RandomXVariant::RX_0;
+                    RandomX::variantFromString(m_config.getMiningConfig().algorithm, variant);
+                    if (paramList.size() > 3 && !paramList[3].empty() &&
+                        !RandomX::variantFromString(paramList[3], variant)) {
+                        LOG_WARNING("Job {} uses unsupported algo {}, mining it as {}", paramList[0], paramList[3],
+                                    RandomX::variantToString(variant));
+                    }
+                    job.algo = RandomX::variantToString(variant);
+                    if (!decodeJob(job)) {
+                        LOG_WARNING("Ignoring job {} with an invalid blob or target", job.jobId);
+                        return;
+                    }
+                    
+                    // Nicehash pools put their reserved top nonce bytes in the blob; they must survive
+                    const uint8_t* poolNonce = job.blobBytes.data() + job.nonceOffset;
+                    job.nonces = std::make_shared<NonceAllocator>(
+                        static_cast<uint32_t>(m_config.getMiningConfig().nonceReservedBytes),
+                        poolNonce[0] | (poolNonce[1] << 8) | (poolNonce[2] << 16) | (static_cast<uint32_t>(poolNonce[3]) << 24),
+                        static_cast<uint32_t>(m_config.getMiningConfig().nonceInstances),
+                        static_cast<uint32_t>(m_config.getMiningConfig().nonceInstance));
+                    job.isValid = true;
                     
                     LOG_INFO("New Monero job received: {} (blob: {}...)", 
-                             m_currentJob.jobId, m_currentJob.blob.substr(0, 16));
-                    LOG_DEBUG("Job details - Target: {}, Algo: {}, Height: {}", 
-                             m_currentJob.target, 
+                             job.jobId, job.blob.substr(0, 16));
+                    LOG_DEBUG("Job details - Target: {}, Algo: {}, Height: {}, Seed: {}", 
+                             job.target, 
                              paramList.size() > 3 ? paramList[3] : "unknown",
-                             paramList.size() > 4 ? paramList[4] : "unknown");
+                             paramList.size() > 4 ? paramList[4] : "unknown",
+                             job.seedHash.empty() ? "unknown" : job.seedHash);
+                    
+                    // Jobs for a seed whose dataset is not built yet wait in m_pendingJob
+                    if (updateSeed(job, paramList.size() > 6 ? paramList[6] : "")) {
+                        publishJob(job);
+                    }
                 } else {
                     LOG_WARNING("Incomplete job parameters: {}", message);
                 }
@@ -648,6 +1064,8 @@ void Miner::processPoolMessage(const std::string& message) {
     } else if (message.find("\"method\":\"mining.set_difficulty\"") != std::string::npos) {
         // Handle difficulty change
         LOG_INFO("Difficulty changed: {}", message);
+    } else if (completeShare(message)) {
+        // Answer to a submitted share, counted by processShareResponse()
     } else if (message.find("\"result\"") != std::string::npos) {
         // Handle other responses (login, subscribe, etc.)
         LOG_DEBUG("Pool response: {}", message);
@@ -659,6 +1077,95 @@ void Miner::processPoolMessage(const std::string& message) {
     }
 }
 
+bool Miner::updateSeed(const MiningJob& job, const std::string& nextSeedHash) {
+    std::lock_guard<std::mutex> lock(m_seedMutex);
+    
+    // A dataset is identified by seed and variant; a job without a seed keeps the current one
+    const std::string seedHash = job.seedHash.empty() ? m_seedHash : job.seedHash;
+    bool ready = seedHash == m_seedHash && job.algo == m_algo;
+    bool built = seedHash == m_nextSeedHash && job.algo == m_nextAlgo;
+    if (!ready && built && m_randomx->isNextKeyReady()) {
+        // Built ahead of time from next_seed_hash: switch together with this job
+        activateNextSeed();
+        ready = true;
+    }
+    
+    if (ready) {
+        m_pendingJob.isValid = false;
+        if (!nextSeedHash.empty() && nextSeedHash != m_seedHash && nextSeedHash != m_nextSeedHash &&
+            !m_randomx->isNextKeyBuilding()) {
+            startSeedBuild(nextSeedHash, job.algo);
+        }
+        return true;
+    }
+    
+    // Keep hashing the current job until seedLoop() has the new dataset
+    if (!m_pendingJob.isValid) {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+    m_pendingJob = job;
+    m_pendingJob.seedHash = seedHash;
+    if (!built && !m_randomx->isNextKeyBuilding()) {
+        startSeedBuild(seedHash, job.algo);
+    }
+    LOG_INFO("Job {} uses {} seed {}, mining continues on the current dataset until it is built",
+             job.jobId, job.algo, seedHash.substr(0, 16));
+    return false;
+}
+
+void Miner::startSeedBuild(const std::string& seedHash, const std::string& algo) {
+    std::vector<uint8_t> key = RandomX::hexToBytes(seedHash);
+    if (key.size() != 32) {
+        LOG_WARNING("Ignoring invalid seed hash: {}", seedHash);
+        return;
+    }
+    
+    RandomXVariant variant = RandomXVariant::RX_0;
+    RandomX::variantFromString(algo, variant);
+    if (m_randomx->prepareNextKey(key.data(), key.size(), variant)) {
+        m_nextSeedHash = seedHash;
+        m_nextAlgo = algo;
+    }
+}
+
+void Miner::activateNextSeed() {
+    if (!m_randomx->activateNextKey()) {
+        return;
+    }
+    
+    m_seedHash = m_nextSeedHash;
+    m_algo = m_nextAlgo;
+    m_nextSeedHash.clear();
+    m_nextAlgo.clear();
+    LOG_INFO("RandomX dataset switched to {} seed {}", m_algo, m_seedHash.substr(0, 16));
+}
+
+void Miner::seedLoop() {
+    while (m_running) {
+        {
+            std::lock_guard<std::mutex> lock(m_seedMutex);
+            if (m_pendingJob.isValid && !m_randomx->isNextKeyBuilding()) {
+                if (m_pendingJob.seedHash == m_nextSeedHash && m_pendingJob.algo == m_nextAlgo &&
+                    m_randomx->isNextKeyReady()) {
+                    activateNextSeed();
+                    publishJob(m_pendingJob);
+                    m_pendingJob.isValid = false;
+                    
+                    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - m_pendingSince);
+                    LOG_INFO("Switched to job {} after {} ms on the previous dataset",
+                             m_pendingJob.jobId, waited.count());
+                } else {
+                    // Nothing built for this seed yet (or a build for another seed just finished)
+                    startSeedBuild(m_pendingJob.seedHash, m_pendingJob.algo);
+                }
+            }
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
 std::string Miner::extractJsonValue(const std::string& json, const std::string& key) {
     std::string searchKey = "\"" + key + "\":\"";
     size_t start = json.find(searchKey);
@@ -673,14 +1180,27 @@ std::string Miner::extractJsonValue(const std::string& json, const std::string&
     return json.substr(start, end - start);
 }
 
-std::vector<uint8_t> Miner::hexToBytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        std::string byteString = hex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(std::stoul(byteString, nullptr, 16));
-        bytes.push_back(byte);
+bool Miner::extractJsonId(const std::string& json, uint64_t& id) {
+    size_t pos = json.find("\"id\":");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += 5;
+    while (pos < json.size() && json[pos] == ' ') {
+        pos++;
     }
-    return bytes;
+    if (pos >= json.size() || json[pos] < '0' || json[pos] > '9') {
+        return false;  // null or a string id
+    }
+    id = 0;
+    while (pos < json.size() && json[pos] >= '0' && json[pos] <= '9') {
+        id = id * 10 + static_cast<uint64_t>(json[pos++] - '0');
+    }
+    return true;
+}
+
+std::vector<uint8_t> Miner::hexToBytes(const std::string& hex) {
+    return RandomX::hexToBytes(hex);
 }
 
 bool Miner::isValidMoneroAddress(const std::string& address) {
@@ -741,11 +1261,7 @@ bool Miner::isValidMoneroAddress(const std::string& address) {
 }
 
 std::string Miner::bytesToHex(const uint8_t* bytes, size_t length) {
-    std::ostringstream hex;
-    for (size_t i = 0; i < length; i++) {
-        hex << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(bytes[i]);
-    }
-    return hex.str();
+    return RandomX::bytesToHex(bytes, length);
 }
 
 void Miner::idleLoop() {
@@ -799,7 +1315,14 @@ void Miner::startMining() {
     // Start mining threads
     int numThreads = m_config.getMiningConfig().threads;
     if (numThreads == 0) {
-        numThreads = std::thread::hardware_concurrency();
+        numThreads = m_tunedThreads > 0 ? m_tunedThreads : m_randomx->getWorkerCount();
+    }
+    
+    // One epoch slot per mining thread, replaced only while no mining thread runs
+    {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        m_jobEpochs = std::make_unique<JobEpoch[]>(numThreads);
+        m_jobEpochCount = numThreads;
     }
     
     for (int i = 0; i < numThreads; i++) {
@@ -0,0 +1,39 @@
+#include "nonce_allocator.h"
+#include <algorithm>
+#include <cmath>
+
+NonceAllocator::NonceAllocator(uint32_t reservedBytes, uint32_t poolNonce, uint32_t instances, uint32_t instance)
+    : m_cursor(0), m_capacity(0), m_base(0), m_reservedBytes(std::min(reservedBytes, NONCE_MAX_RESERVED_BYTES)) {
+    const uint32_t freeBits = 32 - 8 * m_reservedBytes;
+    const uint64_t freeSpace = 1ULL << freeBits;
+    const uint32_t reservedMask = static_cast<uint32_t>(~(freeSpace - 1));
+    
+    instances = std::clamp(instances, 1u, NONCE_MAX_INSTANCES);
+    instance = std::min(instance, instances - 1);
+    m_capacity = freeSpace / instances;
+    m_base = (poolNonce & reservedMask) | static_cast<uint32_t>(m_capacity * instance);
+}
+
+bool NonceAllocator::claim(uint32_t count, NonceRange& range) {
+    // The 64-bit cursor cannot wrap, so claims past the end just fail
+    const uint64_t start = m_cursor.fetch_add(count, std::memory_order_relaxed);
+    if (start >= m_capacity || count == 0) {
+        return false;
+    }
+    
+    range.first = m_base + static_cast<uint32_t>(start);
+    range.count = static_cast<uint32_t>(std::min<uint64_t>(count, m_capacity - start));
+    return true;
+}
+
+uint64_t NonceAllocator::getClaimed() const {
+    return std::min(m_cursor.load(std::memory_order_relaxed), m_capacity);
+}
+
+uint32_t NonceAllocator::chunkSize(double hashRate, uint32_t batchSize) {
+    batchSize = std::max(batchSize, 1u);
+    double nonces = std::isfinite(hashRate) && hashRate > 0.0 ? hashRate * NONCE_CHUNK_SECONDS : 0.0;
+    uint64_t batches = static_cast<uint64_t>(std::ceil(nonces / batchSize));
+    batches = std::clamp<uint64_t>(batches, 1, NONCE_MAX_CHUNK / batchSize);
+    return static_cast<uint32_t>(batches * batchSize);
+}
@@ -6,10 +6,54 @@
 #include <algorithm>
 #include <cmath>
 
+void LatencyHistogram::record(double milliseconds) {
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && milliseconds >= bucketUpperMs(bucket)) {
+        bucket++;
+    }
+    m_buckets[bucket]++;
+    m_totalMs.fetch_add(milliseconds);
+    m_count++;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket = 0;
+    }
+    m_count = 0;
+    m_totalMs = 0.0;
+}
+
+double LatencyHistogram::getAverageMs() const {
+    uint64_t count = m_count.load();
+    return count ? m_totalMs.load() / count : 0.0;
+}
+
+double LatencyHistogram::getPercentileMs(double fraction) const {
+    uint64_t count = m_count.load();
+    if (count == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * count));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += m_buckets[bucket].load();
+        if (seen >= rank && seen > 0) {
+            return bucketUpperMs(bucket);
+        }
+    }
+    return bucketUpperMs(BUCKETS - 1);
+}
+
+double LatencyHistogram::bucketUpperMs(size_t index) {
+    return std::ldexp(1.0, static_cast<int>(index));
+}
+
 PerformanceMonitor::PerformanceMonitor() 
     : m_currentHashRate(0.0), m_averageHashRate(0.0), m_peakHashRate(0.0),
-      m_totalHashes(0), m_sharesSubmitted(0), m_sharesAccepted(0), m_sharesRejected(0),
-      m_currentDifficulty(0.0), m_running(false), m_displayActive(false) {
+      m_totalHashes(0), m_sharesSubmitted(0), m_sharesAccepted(0), m_sharesRejected(0), m_sharesStale(0),
+      m_currentDifficulty(0.0), m_jobSwitches(0), m_lastJobSwitchMs(0.0), m_totalJobSwitchMs(0.0),
+      m_maxJobSwitchMs(0.0), m_running(false), m_displayActive(false) {
     m_startTime = std::chrono::steady_clock::now();
     m_lastUpdate = m_startTime;
     m_lastHashTime = m_startTime;
@@ -52,10 +96,16 @@ void PerformanceMonitor::updateHashRate(double hashRate) {
     updateAverages();
 }
 
-void PerformanceMonitor::updateShares(uint64_t submitted, uint64_t accepted, uint64_t rejected) {
+void PerformanceMonitor::updateNodeHashRates(const std::vector<double>& rates) {
+    std::lock_guard<std::mutex> lock(m_nodeMutex);
+    m_nodeHashRates = rates;
+}
+
+void PerformanceMonitor::updateShares(uint64_t submitted, uint64_t accepted, uint64_t rejected, uint64_t stale) {
     m_sharesSubmitted = submitted;
     m_sharesAccepted = accepted;
     m_sharesRejected = rejected;
+    m_sharesStale = stale;
     m_lastUpdate = std::chrono::steady_clock::now();
 }
 
@@ -67,6 +117,24 @@ void PerformanceMonitor::updateJobInfo(const std::string& jobId, const std::stri
     m_lastUpdate = std::chrono::steady_clock::now();
 }
 
+void PerformanceMonitor::recordJobSwitch(double milliseconds) {
+    m_lastJobSwitchMs = milliseconds;
+    m_totalJobSwitchMs.fetch_add(milliseconds);
+    m_jobSwitches++;
+    double previous = m_maxJobSwitchMs.load();
+    while (milliseconds > previous && !m_maxJobSwitchMs.compare_exchange_weak(previous, milliseconds)) {
+    }
+}
+
+void PerformanceMonitor::recordShareLatency(double milliseconds) {
+    m_shareLatency.record(milliseconds);
+}
+
+double PerformanceMonitor::getAverageJobSwitchMs() const {
+    uint64_t switches = m_jobSwitches.load();
+    return switches ? m_totalJobSwitchMs.load() / switches : 0.0;
+}
+
 double PerformanceMonitor::getCurrentHashRate() const {
     return m_currentHashRate.load();
 }
@@ -79,6 +147,11 @@ double PerformanceMonitor::getPeakHashRate() const {
     return m_peakHashRate.load();
 }
 
+std::vector<double> PerformanceMonitor::getNodeHashRates() const {
+    std::lock_guard<std::mutex> lock(m_nodeMutex);
+    return m_nodeHashRates;
+}
+
 uint64_t PerformanceMonitor::getTotalHashes() const {
     return m_totalHashes.load();
 }
@@ -95,6 +168,10 @@ uint64_t PerformanceMonitor::getSharesRejected() const {
     return m_sharesRejected.load();
 }
 
+uint64_t PerformanceMonitor::getSharesStale() const {
+    return m_sharesStale.load();
+}
+
 double PerformanceMonitor::getAcceptanceRate() const {
     uint64_t submitted = m_sharesSubmitted.load();
     uint64_t accepted = m_sharesAccepted.load();
@@ -133,7 +210,8 @@ void PerformanceMonitor::displayStats() {
     std::cout << "\n⛏️  MINING STATISTICS:\n";
     std::cout << "   Shares: " << getSharesSubmitted() << " submitted, " 
               << getSharesAccepted() << " accepted, " 
-              << getSharesRejected() << " rejected\n";
+              << getSharesRejected() << " rejected, "
+              << getSharesStale() << " stale\n";
     std::cout << "   Rate:   " << formatPercentage(getAcceptanceRate()) << " acceptance\n";
     
     std::cout << "\n🌐 POOL INFO:\n";
@@ -174,18 +252,42 @@ std::string PerformanceMonitor::exportStats() const {
     json << "  \"hashRate\": {\n";
     json << "    \"current\": " << getCurrentHashRate() << ",\n";
     json << "    \"average\": " << getAverageHashRate() << ",\n";
-    json << "    \"peak\": " << getPeakHashRate() << "\n";
+    json << "    \"peak\": " << getPeakHashRate() << ",\n";
+    json << "    \"nodes\": [";
+    std::vector<double> nodeRates = getNodeHashRates();
+    for (size_t node = 0; node < nodeRates.size(); node++) {
+        json << (node ? ", " : "") << nodeRates[node];
+    }
+    json << "]\n";
     json << "  },\n";
     json << "  \"shares\": {\n";
     json << "    \"submitted\": " << getSharesSubmitted() << ",\n";
     json << "    \"accepted\": " << getSharesAccepted() << ",\n";
     json << "    \"rejected\": " << getSharesRejected() << ",\n";
+    json << "    \"stale\": " << getSharesStale() << ",\n";
     json << "    \"acceptanceRate\": " << getAcceptanceRate() << "\n";
     json << "  },\n";
     json << "  \"pool\": {\n";
     json << "    \"name\": \"" << getCurrentPool() << "\",\n";
     json << "    \"job\": \"" << getCurrentJob() << "\",\n";
     json << "    \"difficulty\": " << getCurrentDifficulty() << "\n";
+    json << "  },\n";
+    json << "  \"jobSwitch\": {\n";
+    json << "    \"count\": " << getJobSwitches() << ",\n";
+    json << "    \"lastMs\": " << getLastJobSwitchMs() << ",\n";
+    json << "    \"averageMs\": " << getAverageJobSwitchMs() << ",\n";
+    json << "    \"maxMs\": " << getMaxJobSwitchMs() << "\n";
+    json << "  },\n";
+    json << "  \"shareLatency\": {\n";
+    json << "    \"count\": " << m_shareLatency.getCount() << ",\n";
+    json << "    \"averageMs\": " << m_shareLatency.getAverageMs() << ",\n";
+    json << "    \"p50Ms\": " << m_shareLatency.getPercentileMs(0.5) << ",\n";
+    json << "    \"p99Ms\": " << m_shareLatency.getPercentileMs(0.99) << ",\n";
+    json << "    \"buckets\": [";
+    for (size_t bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++) {
+        json << (bucket ? ", " : "") << m_shareLatency.getBucket(bucket);
+    }
+    json << "]\n";
     json << "  }\n";
     json << "}\n";
     
@@ -200,7 +302,13 @@ void PerformanceMonitor::resetStats() {
     m_sharesSubmitted = 0;
     m_sharesAccepted = 0;
     m_sharesRejected = 0;
+    m_sharesStale = 0;
     m_currentDifficulty = 0.0;
+    m_jobSwitches = 0;
+    m_lastJobSwitchMs = 0.0;
+    m_totalJobSwitchMs = 0.0;
+    m_maxJobSwitchMs = 0.0;
+    m_shareLatency.reset();
     
     m_startTime = std::chrono::steady_clock::now();
     m_lastUpdate = m_startTime;
@@ -254,6 +362,12 @@ void PerformanceMonitor::displayHashRate() {
     std::cout << "│ Current: " << std::setw(12) << formatHashRate(getCurrentHashRate()) 
               << " │ Average: " << std::setw(12) << formatHashRate(getAverageHashRate())
               << " │ Peak: " << std::setw(12) << formatHashRate(getPeakHashRate()) << " │\n";
+    std::vector<double> nodeRates = getNodeHashRates();
+    if (nodeRates.size() > 1) {
+        for (size_t node = 0; node < nodeRates.size(); node++) {
+            std::cout << "│ NUMA node " << node << ": " << std::setw(12) << formatHashRate(nodeRates[node]) << " │\n";
+        }
+    }
     std::cout << "└─────────────────────────────────────────────────────────────┘\n";
 }
 
@@ -263,8 +377,11 @@ void PerformanceMonitor::displayShares() {
     std::cout << "│ Shares: " << std::setw(6) << getSharesSubmitted() 
               << " submitted │ " << std::setw(6) << getSharesAccepted() 
               << " accepted │ " << std::setw(6) << getSharesRejected() << " rejected │\n";
+    std::cout << "│ Stale: " << std::setw(6) << getSharesStale() << " dropped before submit │\n";
     std::cout << "│ Rate: " << std::setw(8) << formatPercentage(getAcceptanceRate())
               << " acceptance rate │\n";
+    std::cout << "│ Share ack: " << std::setw(8) << std::fixed << std::setprecision(2)
+              << m_shareLatency.getAverageMs() << " ms avg │ p99 < " << m_shareLatency.getPercentileMs(0.99) << " ms │\n";
     std::cout << "└─────────────────────────────────────────────────────────────┘\n";
 }
 
@@ -275,6 +392,8 @@ void PerformanceMonitor::displayJobInfo() {
               << " │ Difficulty: " << std::setw(8) << std::fixed << std::setprecision(2) 
               << getCurrentDifficulty() << " │\n";
     std::cout << "│ Job: " << std::setw(25) << getCurrentJob() << " │\n";
+    std::cout << "│ Job switch: " << std::setw(8) << std::fixed << std::setprecision(2) << getLastJobSwitchMs()
+              << " ms (avg " << getAverageJobSwitchMs() << " ms) │\n";
     std::cout << "└─────────────────────────────────────────────────────────────┘\n";
 }
 
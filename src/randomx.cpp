@@ -1,4 +1,7 @@
 #include "randomx.h"
+#include "randomx_jit.h"
+#include "cpu_topology.h"
+#include "cpu_features.h"
 #include "logger.h"
 #include <cstring>
 #include <cstdint>
@@ -11,196 +14,1671 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <bit>
+#include <system_error>
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cfenv>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RANDOMX_FLOAT_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RANDOMX_FLOAT_NEON 1
+#endif
+
+// Kernels built for ISA levels above the compile target carry target attributes
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RANDOMX_DISPATCH_X86 1
+#endif
+
+// The logger only substitutes plain {}, so fixed-point figures are formatted first
+static std::string formatFixed(double value, int precision = 2) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(precision) << value;
+    return text.str();
+}
+
+// Read prefetch into all cache levels; a no-op where the compiler offers no hint
+static inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+// Packed float register arithmetic: each helper handles both lanes of a
+// RandomXFloatRegister in one SSE2 or NEON operation (two scalar ops elsewhere)
+#if defined(RANDOMX_FLOAT_SSE2)
+#define RX_FLOAT_BINARY(name, op) \
+    static inline void name(RandomXFloatRegister& dst, const RandomXFloatRegister& src) { \
+        _mm_store_pd(&dst.lo, op(_mm_load_pd(&dst.lo), _mm_load_pd(&src.lo))); \
+    }
+RX_FLOAT_BINARY(floatAdd, _mm_add_pd)
+RX_FLOAT_BINARY(floatSub, _mm_sub_pd)
+RX_FLOAT_BINARY(floatMul, _mm_mul_pd)
+RX_FLOAT_BINARY(floatDiv, _mm_div_pd)
+
+static inline void floatSqrt(RandomXFloatRegister& dst) {
+    _mm_store_pd(&dst.lo, _mm_sqrt_pd(_mm_load_pd(&dst.lo)));
+}
+
+static inline void floatNegate(RandomXFloatRegister& dst) {
+    _mm_store_pd(&dst.lo, _mm_xor_pd(_mm_load_pd(&dst.lo), _mm_set1_pd(-0.0)));
+}
+
+// Two signed 32-bit integers of a scratchpad word, low half in lane 0 (cvtdq2pd)
+static inline RandomXFloatRegister floatFromMemory(uint64_t word) {
+    RandomXFloatRegister value;
+    _mm_store_pd(&value.lo, _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&word))));
+    return value;
+}
+#elif defined(RANDOMX_FLOAT_NEON)
+#define RX_FLOAT_BINARY(name, op) \
+    static inline void name(RandomXFloatRegister& dst, const RandomXFloatRegister& src) { \
+        vst1q_f64(&dst.lo, op(vld1q_f64(&dst.lo), vld1q_f64(&src.lo))); \
+    }
+RX_FLOAT_BINARY(floatAdd, vaddq_f64)
+RX_FLOAT_BINARY(floatSub, vsubq_f64)
+RX_FLOAT_BINARY(floatMul, vmulq_f64)
+RX_FLOAT_BINARY(floatDiv, vdivq_f64)
+
+static inline void floatSqrt(RandomXFloatRegister& dst) {
+    vst1q_f64(&dst.lo, vsqrtq_f64(vld1q_f64(&dst.lo)));
+}
+
+static inline void floatNegate(RandomXFloatRegister& dst) {
+    vst1q_f64(&dst.lo, vnegq_f64(vld1q_f64(&dst.lo)));
+}
+
+static inline RandomXFloatRegister floatFromMemory(uint64_t word) {
+    RandomXFloatRegister value;
+    vst1q_f64(&value.lo, vcvtq_f64_s64(vmovl_s32(vcreate_s32(word))));
+    return value;
+}
+#else
+#define RX_FLOAT_BINARY(name, op) \
+    static inline void name(RandomXFloatRegister& dst, const RandomXFloatRegister& src) { \
+        dst.lo = dst.lo op src.lo; \
+        dst.hi = dst.hi op src.hi; \
+    }
+RX_FLOAT_BINARY(floatAdd, +)
+RX_FLOAT_BINARY(floatSub, -)
+RX_FLOAT_BINARY(floatMul, *)
+RX_FLOAT_BINARY(floatDiv, /)
+
+static inline void floatSqrt(RandomXFloatRegister& dst) {
+    dst.lo = std::sqrt(dst.lo);
+    dst.hi = std::sqrt(dst.hi);
+}
+
+static inline void floatNegate(RandomXFloatRegister& dst) {
+    dst.lo = -dst.lo;
+    dst.hi = -dst.hi;
+}
+
+static inline RandomXFloatRegister floatFromMemory(uint64_t word) {
+    return RandomXFloatRegister{static_cast<double>(static_cast<int32_t>(word)),
+                                static_cast<double>(static_cast<int32_t>(word >> 32))};
+}
+#endif
+#undef RX_FLOAT_BINARY
+
+// Dataset item kernels: four items are walked together so their dependent cache
+// reads overlap; the AVX2 and AVX-512 variants keep each item's eight registers
+// in vectors. Every variant produces the same items as computeDatasetItem().
+namespace {
+    constexpr size_t DATASET_ITEM_GROUP = 4;
+    constexpr uint64_t DATASET_CACHE_LINES = RANDOMX_CACHE_SIZE / 64;
+    constexpr uint64_t DATASET_ITEM_COUNT = RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem);
+    constexpr uint64_t DATASET_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+    using DatasetItemsFunction = void (*)(const uint64_t* cacheWords, uint32_t first, RandomXDatasetItem* items);
+
+    void datasetItemsGeneric(const uint64_t* cacheWords, uint32_t first, RandomXDatasetItem* items) {
+        uint64_t registers[DATASET_ITEM_GROUP][8];
+        uint64_t line[DATASET_ITEM_GROUP];
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            uint64_t itemNumber = (first + j) % DATASET_ITEM_COUNT;
+            for (int i = 0; i < 8; i++) {
+                registers[j][i] = (itemNumber + 1) * DATASET_MULTIPLIER + i;
+            }
+            line[j] = itemNumber % DATASET_CACHE_LINES;
+        }
+        
+        for (size_t access = 0; access < RANDOMX_DATASET_ITEM_ACCESSES; access++) {
+            for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+                const uint64_t* words = cacheWords + line[j] * 8;
+                for (int i = 0; i < 8; i++) {
+                    registers[j][i] = (registers[j][i] ^ words[i]) * DATASET_MULTIPLIER;
+                    registers[j][i] ^= registers[j][i] >> 29;
+                }
+                line[j] = registers[j][access & 7] % DATASET_CACHE_LINES;
+            }
+        }
+        
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            std::memcpy(items[j].data, registers[j], sizeof(items[j].data));
+        }
+    }
+
+#if defined(RANDOMX_DISPATCH_X86)
+    // 64-bit lane multiply by DATASET_MULTIPLIER from three 32x32 products (AVX2 has no vpmullq)
+    __attribute__((target("avx2")))
+    inline __m256i datasetMultiply(__m256i x) {
+        const __m256i low = _mm256_set1_epi64x(DATASET_MULTIPLIER & 0xFFFFFFFFULL);
+        const __m256i high = _mm256_set1_epi64x(DATASET_MULTIPLIER >> 32);
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), low), _mm256_mul_epu32(x, high));
+        return _mm256_add_epi64(_mm256_mul_epu32(x, low), _mm256_slli_epi64(cross, 32));
+    }
+
+    __attribute__((target("avx2")))
+    void datasetItemsAvx2(const uint64_t* cacheWords, uint32_t first, RandomXDatasetItem* items) {
+        __m256i registers[DATASET_ITEM_GROUP][2];
+        uint64_t line[DATASET_ITEM_GROUP];
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            uint64_t itemNumber = (first + j) % DATASET_ITEM_COUNT;
+            __m256i base = _mm256_set1_epi64x(static_cast<long long>((itemNumber + 1) * DATASET_MULTIPLIER));
+            registers[j][0] = _mm256_add_epi64(base, _mm256_setr_epi64x(0, 1, 2, 3));
+            registers[j][1] = _mm256_add_epi64(base, _mm256_setr_epi64x(4, 5, 6, 7));
+            line[j] = itemNumber % DATASET_CACHE_LINES;
+        }
+        
+        for (size_t access = 0; access < RANDOMX_DATASET_ITEM_ACCESSES; access++) {
+            for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+                const __m256i* words = reinterpret_cast<const __m256i*>(cacheWords + line[j] * 8);
+                for (int half = 0; half < 2; half++) {
+                    __m256i x = datasetMultiply(_mm256_xor_si256(registers[j][half], _mm256_loadu_si256(words + half)));
+                    registers[j][half] = _mm256_xor_si256(x, _mm256_srli_epi64(x, 29));
+                }
+            }
+            for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+                alignas(32) uint64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), registers[j][(access & 7) / 4]);
+                line[j] = lanes[access & 3] % DATASET_CACHE_LINES;
+            }
+        }
+        
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(items[j].data), registers[j][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(items[j].data + 4), registers[j][1]);
+        }
+    }
+
+    __attribute__((target("avx512f,avx512dq")))
+    void datasetItemsAvx512(const uint64_t* cacheWords, uint32_t first, RandomXDatasetItem* items) {
+        const __m512i multiplier = _mm512_set1_epi64(static_cast<long long>(DATASET_MULTIPLIER));
+        __m512i registers[DATASET_ITEM_GROUP];
+        uint64_t line[DATASET_ITEM_GROUP];
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            uint64_t itemNumber = (first + j) % DATASET_ITEM_COUNT;
+            registers[j] = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>((itemNumber + 1) * DATASET_MULTIPLIER)),
+                                            _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+            line[j] = itemNumber % DATASET_CACHE_LINES;
+        }
+        
+        for (size_t access = 0; access < RANDOMX_DATASET_ITEM_ACCESSES; access++) {
+            for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+                __m512i x = _mm512_xor_si512(registers[j], _mm512_loadu_si512(cacheWords + line[j] * 8));
+                x = _mm512_mullo_epi64(x, multiplier);
+                registers[j] = _mm512_xor_si512(x, _mm512_srli_epi64(x, 29));
+            }
+            for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+                alignas(64) uint64_t lanes[8];
+                _mm512_store_si512(lanes, registers[j]);
+                line[j] = lanes[access & 7] % DATASET_CACHE_LINES;
+            }
+        }
+        
+        for (size_t j = 0; j < DATASET_ITEM_GROUP; j++) {
+            _mm512_storeu_si512(items[j].data, registers[j]);
+        }
+    }
+#endif
+
+    struct DatasetKernel {
+        DatasetItemsFunction compute;
+        const char* name;
+    };
+
+    const DatasetKernel& datasetKernel() {
+        static const DatasetKernel kernel = [] {
+#if defined(RANDOMX_DISPATCH_X86)
+            const CpuFeatureSet& features = CpuFeatures::detect();
+            if (features.avx512f && features.avx512dq) {
+                return DatasetKernel{datasetItemsAvx512, "avx512"};
+            }
+            if (features.avx2) {
+                return DatasetKernel{datasetItemsAvx2, "avx2"};
+            }
+#endif
+            return DatasetKernel{datasetItemsGeneric, "generic"};
+        }();
+        return kernel;
+    }
+
+    // Hex codec kernels: a table-driven generic path and an SSSE3 path that
+    // encodes 16 bytes and decodes 32 digits per step. Digit pairs containing
+    // a non-hex character are skipped and an odd trailing digit is ignored.
+    constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    constexpr std::array<int8_t, 256> HEX_VALUES = [] {
+        std::array<int8_t, 256> values{};
+        for (int c = 0; c < 256; c++) {
+            values[c] = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        }
+        return values;
+    }();
+
+    using HexEncodeFunction = void (*)(const uint8_t* bytes, size_t length, char* out);
+    using HexDecodeFunction = size_t (*)(const char* hex, size_t pairs, uint8_t* out);
+
+    void hexEncodeGeneric(const uint8_t* bytes, size_t length, char* out) {
+        for (size_t i = 0; i < length; i++) {
+            out[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+            out[2 * i + 1] = HEX_DIGITS[bytes[i] & 15];
+        }
+    }
+
+    size_t hexDecodeGeneric(const char* hex, size_t pairs, uint8_t* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < pairs; i++) {
+            int high = HEX_VALUES[static_cast<uint8_t>(hex[2 * i])];
+            int low = HEX_VALUES[static_cast<uint8_t>(hex[2 * i + 1])];
+            if ((high | low) >= 0) {
+                out[written++] = static_cast<uint8_t>(high << 4 | low);
+            }
+        }
+        return written;
+    }
+
+#if defined(RANDOMX_DISPATCH_X86)
+    __attribute__((target("ssse3")))
+    void hexEncodeSsse3(const uint8_t* bytes, size_t length, char* out) {
+        const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(value, 4), nibble));
+            __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(value, nibble));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+        }
+        hexEncodeGeneric(bytes + i, length - i, out + 2 * i);
+    }
+
+    // Digit values of 16 characters; valid has 0xff in every lane holding a hex digit
+    __attribute__((target("ssse3")))
+    inline __m128i hexValuesSsse3(__m128i chars, __m128i& valid) {
+        __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), chars));
+        __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+        valid = _mm_or_si128(isDigit, isLetter);
+        return _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                            _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    }
+
+    __attribute__((target("ssse3")))
+    size_t hexDecodeSsse3(const char* hex, size_t pairs, uint8_t* out) {
+        const __m128i weights = _mm_set1_epi16(0x0110);   // 16 * high digit + 1 * low digit
+        size_t written = 0;
+        size_t i = 0;
+        for (; i + 16 <= pairs; i += 16) {
+            __m128i validA, validB;
+            __m128i a = hexValuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i)), validA);
+            __m128i b = hexValuesSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i + 16)), validB);
+            if (_mm_movemask_epi8(_mm_and_si128(validA, validB)) != 0xffff) {
+                written += hexDecodeGeneric(hex + 2 * i, 16, out + written);
+                continue;
+            }
+            __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), packed);
+            written += 16;
+        }
+        return written + hexDecodeGeneric(hex + 2 * i, pairs - i, out + written);
+    }
+#endif
+
+    struct HexCodec {
+        HexEncodeFunction encode;
+        HexDecodeFunction decode;
+        const char* name;
+    };
+
+    const HexCodec& hexCodec() {
+        static const HexCodec codec = [] {
+#if defined(RANDOMX_DISPATCH_X86)
+            if (CpuFeatures::detect().ssse3) {
+                return HexCodec{hexEncodeSsse3, hexDecodeSsse3, "ssse3"};
+            }
+#endif
+            return HexCodec{hexEncodeGeneric, hexDecodeGeneric, "generic"};
+        }();
+        return codec;
+    }
+}
+
+// Large page allocation
+namespace RandomXMemory {
+
+static size_t roundUp(size_t size, size_t unit) {
+    return (size + unit - 1) / unit * unit;
+}
+
+#if defined(__linux__)
+static void* mapHugePages(size_t size, int pageShift) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    flags |= pageShift << MAP_HUGE_SHIFT;
+#else
+    (void)pageShift;
+#endif
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+static std::string readSysfsValue(const std::string& path) {
+    std::ifstream file(path);
+    std::string value;
+    if (!file || !std::getline(file, value)) {
+        return "n/a";
+    }
+    return value;
+}
+#endif
+
+RandomXMemoryBlock allocate(size_t size, bool useHugePages, const std::string& purpose) {
+    RandomXMemoryBlock block;
+    
+#if defined(__linux__)
+    if (useHugePages) {
+        constexpr size_t hugePage1G = 1ULL << 30;
+        if (size >= hugePage1G) {
+            block.size = roundUp(size, hugePage1G);
+            block.memory = mapHugePages(block.size, 30);
+            if (block.memory) {
+                block.pages = RandomXPages::HUGE_1G;
+                block.mapped = true;
+                LOG_INFO("RandomX {} backed by 1 GiB pages", purpose);
+                return block;
+            }
+            LOG_INFO("1 GiB pages unavailable for RandomX {} ({}), trying 2 MiB pages", purpose, std::strerror(errno));
+        }
+        
+        block.size = roundUp(size, RANDOMX_DATASET_CHUNK_SIZE);
+        block.memory = mapHugePages(block.size, 21);
+        if (block.memory) {
+            block.pages = RandomXPages::HUGE_2M;
+            block.mapped = true;
+            LOG_INFO("RandomX {} backed by 2 MiB pages", purpose);
+            return block;
+        }
+        LOG_INFO("2 MiB pages unavailable for RandomX {} ({}), trying transparent huge pages", purpose, std::strerror(errno));
+        
+        // Over-map by one huge page and trim both ends so the region is 2 MiB aligned
+        size_t span = block.size + RANDOMX_DATASET_CHUNK_SIZE;
+        void* region = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region != MAP_FAILED) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(region);
+            uintptr_t aligned = roundUp(base, RANDOMX_DATASET_CHUNK_SIZE);
+            if (aligned > base) {
+                munmap(region, aligned - base);
+            }
+            size_t tail = base + span - (aligned + block.size);
+            if (tail > 0) {
+                munmap(reinterpret_cast<void*>(aligned + block.size), tail);
+            }
+            block.memory = reinterpret_cast<void*>(aligned);
+            block.mapped = true;
+            
+            if (madvise(block.memory, block.size, MADV_HUGEPAGE) == 0) {
+                block.pages = RandomXPages::TRANSPARENT;
+                LOG_INFO("RandomX {} backed by transparent huge pages", purpose);
+            } else {
+                LOG_WARNING("Transparent huge pages unavailable for RandomX {} ({}), using standard pages",
+                            purpose, std::strerror(errno));
+            }
+            return block;
+        }
+        LOG_WARNING("Failed to map RandomX {} ({}), using standard pages", purpose, std::strerror(errno));
+    }
+#else
+    if (useHugePages) {
+        LOG_WARNING("Huge pages are not supported on this platform, RandomX {} uses standard pages", purpose);
+    }
+#endif
+    
+    block.size = roundUp(size, RANDOMX_DATASET_CHUNK_SIZE);
+    block.memory = std::aligned_alloc(RANDOMX_DATASET_CHUNK_SIZE, block.size);
+    block.pages = RandomXPages::STANDARD;
+    block.mapped = false;
+    if (!block.memory) {
+        block.size = 0;
+    }
+    return block;
+}
+
+void release(RandomXMemoryBlock& block) {
+    if (block.memory) {
+        if (block.mapped) {
+            munmap(block.memory, block.size);
+        } else {
+            std::free(block.memory);
+        }
+    }
+    block = RandomXMemoryBlock{};
+}
+
+std::string pagesToString(RandomXPages pages) {
+    switch (pages) {
+        case RandomXPages::HUGE_1G: return "1 GiB";
+        case RandomXPages::HUGE_2M: return "2 MiB";
+        case RandomXPages::TRANSPARENT: return "transparent huge";
+        case RandomXPages::STANDARD: return "standard";
+    }
+    return "standard";
+}
+
+std::string hugePageStatus() {
+#if defined(__linux__)
+    const std::string root = "/sys/kernel/mm/hugepages/";
+    std::string status = "2 MiB pages " + readSysfsValue(root + "hugepages-2048kB/free_hugepages") + "/" +
+                         readSysfsValue(root + "hugepages-2048kB/nr_hugepages") + " free, 1 GiB pages " +
+                         readSysfsValue(root + "hugepages-1048576kB/free_hugepages") + "/" +
+                         readSysfsValue(root + "hugepages-1048576kB/nr_hugepages") + " free";
+    
+    // The active THP mode is the bracketed entry, e.g. "always [madvise] never"
+    std::string thp = readSysfsValue("/sys/kernel/mm/transparent_hugepage/enabled");
+    size_t open = thp.find('[');
+    size_t close = thp.find(']');
+    if (open != std::string::npos && close != std::string::npos && close > open) {
+        thp = thp.substr(open + 1, close - open - 1);
+    }
+    return status + ", THP " + thp;
+#else
+    return "huge pages not supported on this platform";
+#endif
+}
+
+} // namespace RandomXMemory
+
+// Persisted dataset layout: one header page followed by the dataset exactly as generated
+constexpr size_t RANDOMX_DATASET_FILE_HEADER_SIZE = 4096;
+constexpr char RANDOMX_DATASET_FILE_MAGIC[8] = {'R', 'X', 'D', 'S', 'E', 'T', '0', '2'};
+
+struct RandomXDatasetFileHeader {
+    char magic[8];
+    uint64_t datasetSize;
+    uint64_t cacheSize;
+    uint64_t itemAccesses;
+    uint32_t keySize;
+    uint8_t key[64];
+    uint64_t checksum;       // over the dataset bytes
+    double coldInitSeconds;  // generation time, reported next to warm loads
+};
+static_assert(sizeof(RandomXDatasetFileHeader) <= RANDOMX_DATASET_FILE_HEADER_SIZE, "dataset file header too large");
+
+// Four independent multiply-xor lanes keep the checksum near memory bandwidth;
+// used for dataset files and to fold each scratchpad into its hash
+static uint64_t memoryChecksum(const void* data, size_t size) {
+    const uint64_t* words = static_cast<const uint64_t*>(data);
+    uint64_t lanes[4] = {1, 2, 3, 4};
+    for (size_t i = 0; i + 4 <= size / 8; i += 4) {
+        for (int j = 0; j < 4; j++) {
+            lanes[j] = (lanes[j] ^ words[i + j]) * 0x9e3779b97f4a7c15ULL;
+        }
+    }
+    uint64_t checksum = 0;
+    for (int j = 0; j < 4; j++) {
+        checksum = (checksum ^ lanes[j] ^ (lanes[j] >> 29)) * 0x9e3779b97f4a7c15ULL;
+    }
+    return checksum;
+}
 
 // RandomXCache Implementation
-RandomXCache::RandomXCache() : m_cache(nullptr), m_dataset(nullptr), m_initialized(false) {
+RandomXCache::RandomXCache()
+    : m_cache(nullptr), m_dataset(nullptr), m_useHugePages(false), m_initialized(false), m_lightMode(false),
+      m_variant(RandomXVariant::RX_0), m_chunksGenerated(0), m_initSeconds(0.0), m_cacheSeconds(0.0), m_datasetMapping(nullptr), m_datasetMappingSize(0),
+      m_datasetFromFile(false) {
 }
 
 RandomXCache::~RandomXCache() {
     destroy();
 }
 
-bool RandomXCache::initialize(const uint8_t* key, size_t keySize) {
+bool RandomXCache::initialize(const uint8_t* key, size_t keySize, bool lightMode, int initThreads) {
     if (m_initialized) {
         return true;
     }
     
+    auto start = std::chrono::steady_clock::now();
+    m_lightMode = lightMode;
+    
     // Allocate cache memory
-    m_cache = std::aligned_alloc(64, RANDOMX_CACHE_SIZE);
+    m_cacheMemory = RandomXMemory::allocate(RANDOMX_CACHE_SIZE, m_useHugePages, "cache");
+    m_cache = m_cacheMemory.memory;
     if (!m_cache) {
         return false;
     }
     
-    // Allocate dataset memory
-    m_dataset = std::aligned_alloc(64, RANDOMX_DATASET_SIZE);
-    if (!m_dataset) {
-        std::free(m_cache);
+    if (initThreads <= 0) {
+        initThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    initThreads = std::max(initThreads, 1);
+    
+    if (!generateCache(key, keySize, initThreads)) {
+        RandomXMemory::release(m_cacheMemory);
         m_cache = nullptr;
         return false;
     }
     
-    generateCache(key, keySize);
-    generateDataset();
+    // Light mode stops here; dataset items are computed from the cache on demand
+    if (lightMode) {
+        m_initSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("RandomX cache initialized in {}s (light mode, {} MB)", formatFixed(m_initSeconds),
+                 RANDOMX_CACHE_SIZE / (1024 * 1024));
+        m_initialized = true;
+        return true;
+    }
+    
+    // A dataset persisted for this key skips generation entirely
+    std::string datasetPath = datasetFilePath(key, keySize);
+    double coldSeconds = 0.0;
+    if (!datasetPath.empty() && loadDatasetFile(datasetPath, key, keySize, coldSeconds)) {
+        m_initSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("RandomX dataset loaded from {} in {}s (warm) vs {}s generated (cold)",
+                 datasetPath, formatFixed(m_initSeconds), formatFixed(coldSeconds));
+    } else {
+        // Allocate dataset memory, chunk aligned so each init thread touches whole pages.
+        // Pages are left untouched here; the thread that generates a chunk faults it in
+        // and so places it on its own NUMA node.
+        m_datasetMemory = RandomXMemory::allocate(RANDOMX_DATASET_SIZE, m_useHugePages, "dataset");
+        m_dataset = m_datasetMemory.memory;
+        if (!m_dataset) {
+            RandomXMemory::release(m_cacheMemory);
+            m_cache = nullptr;
+            return false;
+        }
+        
+        generateDataset(initThreads);
+        
+        m_initSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("RandomX dataset initialized in {}s using {} thread(s), {} pages", formatFixed(m_initSeconds),
+                 initThreads, RandomXMemory::pagesToString(m_datasetMemory.pages));
+        
+        if (!datasetPath.empty()) {
+            saveDatasetFile(datasetPath, key, keySize);
+        }
+    }
+    
+    if (m_numaNodes.size() > 1) {
+        replicateDataset();
+    }
     
     m_initialized = true;
     return true;
 }
 
+bool RandomXCache::replicateDataset() {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<RandomXMemoryBlock> replicas(m_numaNodes.size());
+    std::atomic<bool> failed{false};
+    
+    // Each copy is written by a thread pinned to its node, so first touch places it there
+    auto copyToNode = [this, &replicas, &failed](size_t node) {
+        CpuTopology::pinCurrentThread(m_numaNodes[node].cpus);
+        replicas[node] = RandomXMemory::allocate(RANDOMX_DATASET_SIZE, m_useHugePages,
+                                                 "dataset replica on node " + std::to_string(m_numaNodes[node].id));
+        if (!replicas[node].memory) {
+            failed = true;
+            return;
+        }
+        std::memcpy(replicas[node].memory, m_dataset, RANDOMX_DATASET_SIZE);
+    };
+    
+    std::vector<std::thread> threads;
+    for (size_t node = 0; node < m_numaNodes.size(); node++) {
+        try {
+            threads.emplace_back(copyToNode, node);
+        } catch (const std::system_error& e) {
+            LOG_WARNING("Could not start dataset replica thread for node {}: {}", m_numaNodes[node].id, e.what());
+            failed = true;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    if (failed) {
+        for (auto& replica : replicas) {
+            RandomXMemory::release(replica);
+        }
+        LOG_WARNING("RandomX dataset replication failed, all NUMA nodes share one dataset");
+        return false;
+    }
+    
+    // The replicas replace the shared copy; replica 0 doubles as the default dataset
+    if (m_datasetMapping) {
+        munmap(m_datasetMapping, m_datasetMappingSize);
+        m_datasetMapping = nullptr;
+        m_datasetMappingSize = 0;
+    }
+    RandomXMemory::release(m_datasetMemory);
+    m_replicas = std::move(replicas);
+    m_dataset = m_replicas[0].memory;
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("RandomX dataset replicated to {} NUMA nodes in {}s", m_replicas.size(), formatFixed(seconds));
+    return true;
+}
+
 void RandomXCache::destroy() {
-    if (m_cache) {
-        std::free(m_cache);
-        m_cache = nullptr;
+    RandomXMemory::release(m_cacheMemory);
+    m_cache = nullptr;
+    if (m_datasetMapping) {
+        munmap(m_datasetMapping, m_datasetMappingSize);
+        m_datasetMapping = nullptr;
+        m_datasetMappingSize = 0;
     }
-    if (m_dataset) {
-        std::free(m_dataset);
-        m_dataset = nullptr;
+    RandomXMemory::release(m_datasetMemory);
+    for (auto& replica : m_replicas) {
+        RandomXMemory::release(replica);
     }
+    m_replicas.clear();
+    m_dataset = nullptr;
+    m_datasetFromFile = false;
     m_initialized = false;
+    m_chunksGenerated.store(0, std::memory_order_relaxed);
+}
+
+std::string RandomXCache::datasetFilePath(const uint8_t* key, size_t keySize) const {
+    if (m_datasetCacheDir.empty() || keySize > sizeof(RandomXDatasetFileHeader::key)) {
+        return "";
+    }
+    return (std::filesystem::path(m_datasetCacheDir) /
+            (visitRandomXVariant(m_variant, []<typename Params>() { return std::string(Params::family); }) + "-" +
+             RandomX::bytesToHex(key, keySize) + ".dataset")).string();
+}
+
+bool RandomXCache::loadDatasetFile(const std::string& path, const uint8_t* key, size_t keySize, double& coldSeconds) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_INFO("No persisted RandomX dataset at {}, generating", path);
+        return false;
+    }
+    
+    const size_t fileSize = RANDOMX_DATASET_FILE_HEADER_SIZE + RANDOMX_DATASET_SIZE;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != fileSize) {
+        LOG_WARNING("Persisted RandomX dataset {} has the wrong size, regenerating", path);
+        close(fd);
+        return false;
+    }
+    
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_WARNING("Failed to map persisted RandomX dataset {}, regenerating", path);
+        return false;
+    }
+    
+    const auto* header = static_cast<const RandomXDatasetFileHeader*>(mapping);
+    const uint8_t* dataset = static_cast<const uint8_t*>(mapping) + RANDOMX_DATASET_FILE_HEADER_SIZE;
+    bool valid = std::memcmp(header->magic, RANDOMX_DATASET_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->datasetSize == RANDOMX_DATASET_SIZE && header->cacheSize == RANDOMX_CACHE_SIZE &&
+                 header->itemAccesses == RANDOMX_DATASET_ITEM_ACCESSES && header->keySize == keySize &&
+                 std::memcmp(header->key, key, keySize) == 0;
+    
+    // Full checksum catches truncated or corrupted files; it also pulls the pages in
+    if (valid) {
+        madvise(mapping, fileSize, MADV_WILLNEED);
+        valid = memoryChecksum(dataset, RANDOMX_DATASET_SIZE) == header->checksum;
+    }
+    
+    // Spot-check items against the cache so a file from a different item function is rejected
+    if (valid) {
+        constexpr size_t itemCount = RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem);
+        const auto* items = reinterpret_cast<const RandomXDatasetItem*>(dataset);
+        for (size_t i = 0; valid && i < itemCount; i += itemCount / 64 + 1) {
+            RandomXDatasetItem expected;
+            computeDatasetItem(static_cast<uint32_t>(i), expected);
+            valid = std::memcmp(&expected, &items[i], sizeof(expected)) == 0;
+        }
+    }
+    
+    if (!valid) {
+        LOG_WARNING("Persisted RandomX dataset {} failed its integrity check, regenerating", path);
+        munmap(mapping, fileSize);
+        return false;
+    }
+    
+    madvise(mapping, fileSize, MADV_RANDOM);
+    coldSeconds = header->coldInitSeconds;
+    m_datasetMapping = mapping;
+    m_datasetFromFile = true;
+    m_datasetMappingSize = fileSize;
+    m_dataset = const_cast<uint8_t*>(dataset);
+    return true;
+}
+
+bool RandomXCache::saveDatasetFile(const std::string& path, const uint8_t* key, size_t keySize) const {
+    auto start = std::chrono::steady_clock::now();
+    
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    if (error) {
+        LOG_WARNING("Cannot create RandomX dataset cache directory for {}: {}", path, error.message());
+        return false;
+    }
+    
+    std::vector<uint8_t> headerPage(RANDOMX_DATASET_FILE_HEADER_SIZE, 0);
+    RandomXDatasetFileHeader header{};
+    std::memcpy(header.magic, RANDOMX_DATASET_FILE_MAGIC, sizeof(header.magic));
+    header.datasetSize = RANDOMX_DATASET_SIZE;
+    header.cacheSize = RANDOMX_CACHE_SIZE;
+    header.itemAccesses = RANDOMX_DATASET_ITEM_ACCESSES;
+    header.keySize = static_cast<uint32_t>(keySize);
+    std::memcpy(header.key, key, keySize);
+    header.checksum = memoryChecksum(m_dataset, RANDOMX_DATASET_SIZE);
+    header.coldInitSeconds = m_initSeconds;
+    std::memcpy(headerPage.data(), &header, sizeof(header));
+    
+    // Write under a per-process name and rename, so readers never see a partial file
+    std::string tempPath = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(headerPage.data()), headerPage.size());
+        file.write(static_cast<const char*>(m_dataset), RANDOMX_DATASET_SIZE);
+        if (!file) {
+            LOG_WARNING("Failed to write RandomX dataset to {}", tempPath);
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+    
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_WARNING("Failed to persist RandomX dataset to {}: {}", path, error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("RandomX dataset persisted to {} in {}s", path, formatFixed(seconds));
+    return true;
 }
 
-const RandomXDatasetItem* RandomXCache::getDatasetItem(uint32_t index) const {
+double RandomXCache::getInitProgress() const {
+    constexpr size_t chunkCount = RANDOMX_DATASET_SIZE / RANDOMX_DATASET_CHUNK_SIZE;
+    return static_cast<double>(m_chunksGenerated.load(std::memory_order_relaxed)) / chunkCount;
+}
+
+const RandomXDatasetItem* RandomXCache::getDatasetItem(uint32_t index, size_t node) const {
     if (!m_initialized || !m_dataset) {
         return nullptr;
     }
     
+    const void* dataset = node < m_replicas.size() ? m_replicas[node].memory : m_dataset;
     size_t offset = (index % (RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem))) * sizeof(RandomXDatasetItem);
-    return reinterpret_cast<RandomXDatasetItem*>(static_cast<uint8_t*>(m_dataset) + offset);
+    return reinterpret_cast<const RandomXDatasetItem*>(static_cast<const uint8_t*>(dataset) + offset);
+}
+
+// Simplified SuperscalarHash: each item folds RANDOMX_DATASET_ITEM_ACCESSES cache
+// lines into eight registers, the next line chosen by the mixed state, so an
+// item cannot be produced without walking the cache
+void RandomXCache::computeDatasetItem(uint32_t index, RandomXDatasetItem& item) const {
+    constexpr uint64_t cacheLines = RANDOMX_CACHE_SIZE / 64;
+    const uint64_t* cacheWords = static_cast<const uint64_t*>(m_cache);
+    uint64_t itemNumber = index % (RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem));
+    
+    uint64_t registers[8];
+    for (int i = 0; i < 8; i++) {
+        registers[i] = (itemNumber + 1) * 0x9e3779b97f4a7c15ULL + i;
+    }
+    
+    uint64_t line = itemNumber % cacheLines;
+    for (size_t access = 0; access < RANDOMX_DATASET_ITEM_ACCESSES; access++) {
+        const uint64_t* words = cacheWords + line * 8;
+        for (int i = 0; i < 8; i++) {
+            registers[i] = (registers[i] ^ words[i]) * 0x9e3779b97f4a7c15ULL;
+            registers[i] ^= registers[i] >> 29;
+        }
+        line = registers[access & 7] % cacheLines;
+    }
+    
+    std::memcpy(item.data, registers, sizeof(item.data));
+}
+
+void RandomXCache::computeDatasetItems(uint32_t firstIndex, size_t count, RandomXDatasetItem* items) const {
+    const uint64_t* cacheWords = static_cast<const uint64_t*>(m_cache);
+    DatasetItemsFunction compute = ::datasetKernel().compute;
+    
+    size_t i = 0;
+    for (; i + DATASET_ITEM_GROUP <= count; i += DATASET_ITEM_GROUP) {
+        compute(cacheWords, static_cast<uint32_t>(firstIndex + i), items + i);
+    }
+    for (; i < count; i++) {
+        computeDatasetItem(static_cast<uint32_t>(firstIndex + i), items[i]);
+    }
+}
+
+std::string RandomXCache::datasetKernel() {
+    return ::datasetKernel().name;
+}
+
+// Argon2d over the whole cache keyed by the seed; lanes fill in parallel. The
+// variant sets the pass count and salt.
+bool RandomXCache::generateCache(const uint8_t* key, size_t keySize, int threads) {
+    RandomXArgon2Params params = visitRandomXVariant(m_variant, []<typename Params>() {
+        RandomXArgon2Params variantParams;
+        variantParams.passes = Params::argonPasses;
+        variantParams.salt = reinterpret_cast<const uint8_t*>(Params::argonSalt);
+        variantParams.saltSize = sizeof(Params::argonSalt) - 1;
+        return variantParams;
+    });
+    params.memoryKiB = RANDOMX_CACHE_SIZE / 1024;
+    params.lanes = RANDOMX_ARGON_LANES;
+    params.password = key;
+    params.passwordSize = keySize;
+    
+    threads = std::min(threads, static_cast<int>(RANDOMX_ARGON_LANES));
+    auto start = std::chrono::steady_clock::now();
+    if (!RandomXArgon2::fillMemory(m_cache, params, threads)) {
+        LOG_ERROR("RandomX cache generation failed");
+        return false;
+    }
+    m_cacheSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("RandomX {} cache (Argon2d, {} kernel) built in {}s using {} thread(s)",
+             RandomX::variantToString(m_variant), RandomXArgon2::kernelToString(RandomXArgon2::activeKernel()),
+             formatFixed(m_cacheSeconds), threads);
+    return true;
+}
+
+void RandomXCache::generateDataset(int threadCount) {
+    constexpr size_t chunkCount = RANDOMX_DATASET_SIZE / RANDOMX_DATASET_CHUNK_SIZE;
+    threadCount = std::clamp(threadCount, 1, static_cast<int>(chunkCount));
+    m_chunksGenerated.store(0, std::memory_order_relaxed);
+    
+    // The calling thread logs progress in 10% steps
+    int reported = 0;
+    auto reportProgress = [this, &reported]() {
+        int percent = static_cast<int>(getInitProgress() * 100.0);
+        if (percent >= reported + 10) {
+            reported = percent - percent % 10;
+            LOG_INFO("RandomX dataset generation: {}%", reported);
+        }
+    };
+    
+    // Each thread owns one contiguous range of chunks
+    auto generateRange = [this, threadCount, &reportProgress](int thread) {
+        size_t first = chunkCount * thread / threadCount;
+        size_t last = chunkCount * (thread + 1) / threadCount;
+        for (size_t chunk = first; chunk < last; chunk++) {
+            generateDatasetChunk(chunk);
+            m_chunksGenerated.fetch_add(1, std::memory_order_relaxed);
+            if (thread == 0) {
+                reportProgress();
+            }
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < threadCount; thread++) {
+        try {
+            threads.emplace_back(generateRange, thread);
+        } catch (const std::system_error& e) {
+            LOG_WARNING("Could not start dataset init thread {}: {}", thread, e.what());
+            generateRange(thread);
+        }
+    }
+    
+    // The calling thread takes range 0, then keeps reporting until the rest finish
+    generateRange(0);
+    while (m_chunksGenerated.load(std::memory_order_relaxed) < chunkCount) {
+        reportProgress();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void RandomXCache::generateDatasetChunk(size_t chunk) {
+    RandomXDatasetItem* items = static_cast<RandomXDatasetItem*>(m_dataset);
+    
+    constexpr size_t itemsPerChunk = RANDOMX_DATASET_CHUNK_SIZE / sizeof(RandomXDatasetItem);
+    size_t begin = chunk * itemsPerChunk;
+    computeDatasetItems(static_cast<uint32_t>(begin), itemsPerChunk, items + begin);
+}
+
+// RandomXVM Implementation
+RandomXVM::RandomXVM() 
+    : m_scratchpad(nullptr), m_programCounter(0), m_decodedValid(false), m_engine(RandomXEngine::THREADED),
+      m_prefetchDistance(RANDOMX_DEFAULT_PREFETCH_DISTANCE), m_prefetchHintCount(0),
+      m_jitValid(false), m_instructionCount(0), m_cycleCount(0), 
+      m_branchRegister(0), m_branchTarget(0), m_roundingMode(RANDOMX_ROUNDING_NEAREST), m_cache(nullptr),
+      m_variant(RandomXVariant::RX_0), m_numaNode(0),
+      m_lightMode(false), m_initialized(false), m_datasetIndex(0), m_lightItem{}, m_lightItemIndex(UINT32_MAX) {
+    reset();
+}
+
+RandomXVM::~RandomXVM() {
+    destroy();
+}
+
+bool RandomXVM::initialize(RandomXCache* cache, bool lightMode, void* scratchpad) {
+    if (m_initialized) {
+        return true;
+    }
+    
+    if (!scratchpad) {
+        m_scratchpadMemory = RandomXMemory::allocate(RANDOMX_SCRATCHPAD_SIZE, false, "scratchpad");
+        scratchpad = m_scratchpadMemory.memory;
+        if (!scratchpad) {
+            LOG_ERROR("Failed to allocate RandomX scratchpad");
+            return false;
+        }
+    }
+    m_scratchpad = static_cast<uint64_t*>(scratchpad);
+    
+    // A light cache has no dataset to read, whatever the caller asked for
+    m_cache = cache;
+    if (cache) {
+        m_variant = cache->getVariant();
+    }
+    m_lightMode = lightMode || (cache && cache->isLightMode());
+    m_lightItemIndex = UINT32_MAX;
+    m_initialized = true;
+    
+    return true;
+}
+
+void RandomXVM::destroy() {
+    m_initialized = false;
+    m_cache = nullptr;
+    m_scratchpad = nullptr;
+    RandomXMemory::release(m_scratchpadMemory);
+}
+
+void RandomXVM::setCache(RandomXCache* cache) {
+    m_cache = cache;
+    if (cache) {
+        m_variant = cache->getVariant();
+    }
+    m_lightItemIndex = UINT32_MAX;
+}
+
+size_t RandomXVM::getScratchpadSize() const {
+    return visitRandomXVariant(m_variant, []<typename Params>() { return Params::scratchpadL3; });
+}
+
+void RandomXVM::reset() {
+    std::fill(m_registers.begin(), m_registers.end(), 0);
+    std::fill(m_fregisters.begin(), m_fregisters.end(), RandomXFloatRegister{0.0, 0.0});
+    std::fill(m_program.begin(), m_program.end(), RandomXInstruction{});
+    buildPrefetchHints();
+    m_decodedValid = false;
+    m_jitValid = false;
+    
+    m_programCounter = 0;
+    m_instructionCount = 0;
+    m_cycleCount = 0;
+    m_branchRegister = 0;
+    m_branchTarget = 0;
+    m_datasetIndex = 0;
+}
+
+void RandomXVM::loadProgram(const uint8_t* seed, size_t seedSize) {
+    generateProgram(seed, seedSize);
+    buildPrefetchHints();
+    if (m_scratchpad) {
+        fillScratchpad();
+    }
+    
+    if (m_engine == RandomXEngine::INTERPRETER) {
+        return;
+    }
+    if (m_engine == RandomXEngine::JIT && compileJit()) {
+        return;
+    }
+    decodeProgram();
+}
+
+void RandomXVM::execute() {
+    if (!m_initialized) {
+        return;
+    }
+    
+    switch (m_engine) {
+        case RandomXEngine::JIT:
+            if (m_jitValid || compileJit()) {
+                executeJit();
+                break;
+            }
+            executeThreaded();
+            break;
+        case RandomXEngine::THREADED:
+            executeThreaded();
+            break;
+        case RandomXEngine::INTERPRETER:
+            executeInterpreted();
+            break;
+    }
+    
+    // Programs start in round-to-nearest and leave the thread that way
+    if (m_roundingMode != RANDOMX_ROUNDING_NEAREST) {
+        setRoundingMode(RANDOMX_ROUNDING_NEAREST);
+        m_roundingMode = RANDOMX_ROUNDING_NEAREST;
+    }
+    mixDatasetItem();
+}
+
+// Per-hash scratchpad contents: the AES stream that produced the program
+// continues over the variant's L3 tier, so the fill runs at the AES kernel's bandwidth
+void RandomXVM::fillScratchpad() {
+    visitRandomXVariant(m_variant, [this]<typename Params>() {
+        RandomXAes::fill(m_aesState, m_scratchpad, Params::scratchpadL3);
+    });
+}
+
+// Issued as each engine starts the program, so the miss overlaps all of its
+// instructions; light mode computes items on demand and has nothing to fetch
+void RandomXVM::prefetchDatasetItem() const {
+    if (m_cache && !m_lightMode) {
+        prefetchRead(m_cache->getDatasetItem(m_datasetIndex, m_numaNode));
+    }
+}
+
+// One dataset item per program, as RandomX reads one per iteration: its index
+// was fixed when the program was generated and its words are folded into the
+// final registers
+void RandomXVM::mixDatasetItem() {
+    if (!m_cache) {
+        return;
+    }
+    
+    const uint32_t index = m_datasetIndex;
+    const RandomXDatasetItem* item = nullptr;
+    if (!m_lightMode) {
+        item = m_cache->getDatasetItem(index, m_numaNode);
+    } else {
+        // Repeated programs (e.g. benchmarks) often land on the same item
+        if (index != m_lightItemIndex) {
+            m_cache->computeDatasetItem(index, m_lightItem);
+            m_lightItemIndex = index;
+        }
+        item = &m_lightItem;
+    }
+    
+    if (item) {
+        for (int i = 0; i < 8; i++) {
+            m_registers[i] ^= item->data[i];
+        }
+    }
+}
+
+void RandomXVM::setEngine(RandomXEngine engine) {
+    if (engine == RandomXEngine::JIT && !RandomXJitCompiler::isSupported()) {
+        engine = RandomXEngine::THREADED;
+    }
+    m_engine = engine;
+}
+
+void RandomXVM::setPrefetchDistance(uint32_t distance) {
+    m_prefetchDistance = std::min(distance, RANDOMX_MAX_PREFETCH_DISTANCE);
+    buildPrefetchHints();
+    m_decodedValid = false;
+    m_jitValid = false;
+}
+
+void RandomXVM::executeInterpreted() {
+    prefetchDatasetItem();
+    size_t hint = 0;
+    
+    for (int i = 0; i < RANDOMX_PROGRAM_SIZE; i++) {
+        for (; hint < m_prefetchHintCount && m_prefetchHints[hint].issue == i; hint++) {
+            prefetchRead(&m_scratchpad[getMemoryAddress(m_program[m_prefetchHints[hint].target]) / 8]);
+        }
+        executeInstruction(m_program[i]);
+        m_instructionCount++;
+        m_cycleCount++;
+    }
+}
+
+uint64_t RandomXVM::getRegister(int index) const {
+    if (index >= 0 && index < 8) {
+        return m_registers[index];
+    }
+    return 0;
+}
+
+void RandomXVM::setRegister(int index, uint64_t value) {
+    if (index >= 0 && index < 8) {
+        m_registers[index] = value;
+    }
+}
+
+double RandomXVM::getFloatRegister(int index, int lane) const {
+    if (index >= 0 && index < 8) {
+        return lane == 0 ? m_fregisters[index].lo : m_fregisters[index].hi;
+    }
+    return 0.0;
+}
+
+uint64_t RandomXVM::getScratchpad(int index) const {
+    if (m_scratchpad && index >= 0 && static_cast<size_t>(index) < RANDOMX_SCRATCHPAD_SIZE / 8) {
+        return m_scratchpad[index];
+    }
+    return 0;
+}
+
+void RandomXVM::setScratchpad(int index, uint64_t value) {
+    if (m_scratchpad && index >= 0 && static_cast<size_t>(index) < RANDOMX_SCRATCHPAD_SIZE / 8) {
+        m_scratchpad[index] = value;
+    }
+}
+
+// Every variant's scratchpad fits the RANDOMX_SCRATCHPAD_SIZE allocation
+static_assert(RandomXParams<RandomXVariant::RX_WOW>::scratchpadL3 <= RANDOMX_SCRATCHPAD_SIZE);
+static_assert(RandomXParams<RandomXVariant::RX_ARQ>::scratchpadL3 <= RANDOMX_SCRATCHPAD_SIZE);
+
+template <typename Params>
+static uint8_t instructionTier(const RandomXInstruction& instruction) {
+    return instruction.type == RandomXInstructionType::ISTORE ? RandomXVM::storeTier<Params>(instruction)
+                                                              : RandomXVM::loadTier<Params>(instruction);
+}
+
+// Resolve the tier once per instruction so no engine ever looks at the variant
+void RandomXVM::assignTier(RandomXInstruction& instruction) const {
+    instruction.tier = visitRandomXVariant(m_variant, [&instruction]<typename Params>() {
+        return instructionTier<Params>(instruction);
+    });
+}
+
+const RandomXInstruction& RandomXVM::getInstruction(int index) const {
+    if (index >= 0 && index < RANDOMX_PROGRAM_SIZE) {
+        return m_program[index];
+    }
+    static RandomXInstruction empty = {};
+    return empty;
+}
+
+void RandomXVM::setInstruction(int index, const RandomXInstruction& instruction) {
+    if (index >= 0 && index < RANDOMX_PROGRAM_SIZE) {
+        m_program[index] = instruction;
+        assignTier(m_program[index]);
+        buildPrefetchHints();
+        m_decodedValid = false;
+        m_jitValid = false;
+    }
+}
+
+// Threaded engine
+//
+// Each program is decoded once into 8-byte instructions. Operations that
+// cannot change VM state for the given operands (ISWAP r,r, IMUL_RCP by
+// zero) are folded into NOP, IMUL_RCP reciprocals are computed up front into
+// a constant pool and CFROUND keeps its rotate count in shift. Prefetch hints become PREFETCH entries
+// placed in front of their issue instruction.
+void RandomXVM::decodeProgram() {
+    size_t out = 0;
+    size_t hint = 0;
+    
+    for (uint32_t pc = 0; pc < RANDOMX_PROGRAM_SIZE; pc++) {
+        const RandomXInstruction& instruction = m_program[pc];
+        
+        for (; hint < m_prefetchHintCount && m_prefetchHints[hint].issue == pc; hint++) {
+            const RandomXInstruction& target = m_program[m_prefetchHints[hint].target];
+            uint8_t src = (target.src & 7) == (target.dst & 7) ? RANDOMX_DECODED_ZERO_REGISTER : target.src & 7;
+            m_decodedProgram[out++] = RandomXDecodedInstruction{RANDOMX_DECODED_PREFETCH, 0,
+                src, target.tier, target.imm32};
+        }
+        
+        RandomXDecodedInstruction& decoded = m_decodedProgram[out++];
+        
+        decoded.opcode = static_cast<uint8_t>(instruction.type);
+        decoded.dst = instruction.dst & 7;
+        decoded.src = instruction.src & 7;
+        decoded.shift = instruction.modShift;
+        decoded.imm32 = instruction.imm32;
+        
+        if (readsScratchpad(instruction.type)) {
+            decoded.shift = instruction.tier;
+            if (decoded.src == decoded.dst) {
+                decoded.src = RANDOMX_DECODED_ZERO_REGISTER;
+            }
+        }
+        
+        switch (instruction.type) {
+            case RandomXInstructionType::ISTORE:
+                decoded.shift = instruction.tier;
+                break;
+            case RandomXInstructionType::IMUL_RCP:
+                if (instruction.imm32 == 0) {
+                    decoded.opcode = static_cast<uint8_t>(RandomXInstructionType::NOP);
+                } else {
+                    m_decodedConstants[pc] = 0xFFFFFFFFFFFFFFFFULL / instruction.imm32;
+                    decoded.imm32 = pc;
+                }
+                break;
+            case RandomXInstructionType::ISWAP_R:
+            case RandomXInstructionType::FSWAP_R:
+                if (decoded.dst == decoded.src) {
+                    decoded.opcode = static_cast<uint8_t>(RandomXInstructionType::NOP);
+                }
+                break;
+            case RandomXInstructionType::CFROUND:
+                decoded.shift = instruction.imm32 & 63;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    m_decodedProgram[out] = RandomXDecodedInstruction{RANDOMX_DECODED_HALT, 0, 0, 0, 0};
+    m_decodedValid = true;
+}
+
+bool RandomXVM::readsScratchpad(RandomXInstructionType type) {
+    switch (type) {
+        case RandomXInstructionType::IADD_M:
+        case RandomXInstructionType::ISUB_M:
+        case RandomXInstructionType::IMUL_M:
+        case RandomXInstructionType::IMULH_M:
+        case RandomXInstructionType::ISMULH_M:
+        case RandomXInstructionType::IXOR_M:
+        case RandomXInstructionType::FADD_M:
+        case RandomXInstructionType::FSUB_M:
+        case RandomXInstructionType::FDIV_M:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RandomXVM::writesRegister(const RandomXInstruction& instruction, uint8_t reg) {
+    switch (instruction.type) {
+        case RandomXInstructionType::ISWAP_R:
+            return instruction.dst == reg || instruction.src == reg;
+        case RandomXInstructionType::IADD_RS:
+        case RandomXInstructionType::IADD_M:
+        case RandomXInstructionType::ISUB_R:
+        case RandomXInstructionType::ISUB_M:
+        case RandomXInstructionType::IMUL_R:
+        case RandomXInstructionType::IMUL_M:
+        case RandomXInstructionType::IMULH_R:
+        case RandomXInstructionType::IMULH_M:
+        case RandomXInstructionType::ISMULH_R:
+        case RandomXInstructionType::ISMULH_M:
+        case RandomXInstructionType::IMUL_RCP:
+        case RandomXInstructionType::INEG_R:
+        case RandomXInstructionType::IXOR_R:
+        case RandomXInstructionType::IXOR_M:
+        case RandomXInstructionType::IROR_R:
+        case RandomXInstructionType::IROL_R:
+            return instruction.dst == reg;
+        default:
+            return false;
+    }
 }
 
-void RandomXCache::generateCache(const uint8_t* key, size_t keySize) {
-    // Simplified cache generation
-    // In a real implementation, this would use the full RandomX cache generation algorithm
-    uint8_t* cacheBytes = static_cast<uint8_t*>(m_cache);
-    for (size_t i = 0; i < RANDOMX_CACHE_SIZE; i += 32) {
-        // Generate deterministic data based on key
-        uint64_t seed = 0;
-        for (size_t j = 0; j < keySize; j++) {
-            seed ^= key[j] << ((j % 8) * 8);
-        }
-        seed ^= i;
+// A memory operand's address is final once the last write to its source
+// register has retired, so its prefetch is hoisted to just after that write,
+// but never more than m_prefetchDistance instructions ahead
+void RandomXVM::buildPrefetchHints() {
+    m_prefetchHintCount = 0;
+    if (m_prefetchDistance == 0) {
+        return;
+    }
+    
+    std::array<int, 8> lastWrite;
+    lastWrite.fill(-1);
+    
+    for (int pc = 0; pc < static_cast<int>(RANDOMX_PROGRAM_SIZE); pc++) {
+        const RandomXInstruction& instruction = m_program[pc];
         
-        // Simple hash function
-        uint64_t hash = seed;
-        for (int k = 0; k < 4; k++) {
-            hash = hash * 0x9e3779b97f4a7c15ULL;
-            hash ^= hash >> 33;
+        if (readsScratchpad(instruction.type)) {
+            // The L3 form (src == dst) is addressed by imm32 alone
+            int ready = (instruction.src & 7) == (instruction.dst & 7) ? 0 : lastWrite[instruction.src & 7] + 1;
+            int issue = std::max(pc - static_cast<int>(m_prefetchDistance), ready);
+            if (issue < pc) {
+                m_prefetchHints[m_prefetchHintCount++] =
+                    RandomXPrefetchHint{static_cast<uint8_t>(issue), static_cast<uint8_t>(pc)};
+            }
         }
         
-        // Store hash in cache
-        for (int k = 0; k < 4; k++) {
-            *reinterpret_cast<uint64_t*>(cacheBytes + i + k * 8) = hash;
-            hash = hash * 0x9e3779b97f4a7c15ULL;
+        for (uint8_t reg = 0; reg < 8; reg++) {
+            if (writesRegister(instruction, reg)) {
+                lastWrite[reg] = pc;
+            }
         }
     }
-}
-
-void RandomXCache::generateDataset() {
-    // Simplified dataset generation
-    uint8_t* datasetBytes = static_cast<uint8_t*>(m_dataset);
-    uint8_t* cacheBytes = static_cast<uint8_t*>(m_cache);
     
-    for (size_t i = 0; i < RANDOMX_DATASET_SIZE; i += 64) {
-        uint32_t cacheIndex = (i / 64) % (RANDOMX_CACHE_SIZE / 64);
-        std::memcpy(datasetBytes + i, cacheBytes + cacheIndex * 64, 64);
+    std::stable_sort(m_prefetchHints.begin(), m_prefetchHints.begin() + m_prefetchHintCount,
+                     [](const RandomXPrefetchHint& a, const RandomXPrefetchHint& b) {
+                         return a.issue < b.issue;
+                     });
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RANDOMX_COMPUTED_GOTO 1
+#else
+#define RANDOMX_COMPUTED_GOTO 0
+#endif
+
+// Handlers over pre-decoded instructions, shared by the threaded and lockstep
+// engines. They operate on the locals r, f, scratchpad, constants,
+// branchRegister, roundingMode (the mode the FPU is in) and ip; each engine
+// supplies RX_HANDLER and RX_NEXT.
+#define RX_MASK(ins) ((1u << (ins)->shift) - 1)
+#define RX_ADDRESS(ins, reg) ((static_cast<uint32_t>(r[(ins)->reg] + (ins)->imm32) & RX_MASK(ins)) & ~7u)
+#define RX_MEM(ins) scratchpad[RX_ADDRESS(ins, src) / 8]
+
+#define RX_DECODED_HANDLERS \
+    RX_PREFETCH_HANDLER prefetchRead(&RX_MEM(ip)); RX_NEXT(); \
+    RX_HANDLER(IADD_RS) r[ip->dst] += r[ip->src] << ip->shift; RX_NEXT(); \
+    RX_HANDLER(IADD_M) r[ip->dst] += RX_MEM(ip); RX_NEXT(); \
+    RX_HANDLER(ISUB_R) r[ip->dst] -= r[ip->src]; RX_NEXT(); \
+    RX_HANDLER(ISUB_M) r[ip->dst] -= RX_MEM(ip); RX_NEXT(); \
+    RX_HANDLER(IMUL_R) r[ip->dst] *= r[ip->src]; RX_NEXT(); \
+    RX_HANDLER(IMUL_M) r[ip->dst] *= RX_MEM(ip); RX_NEXT(); \
+    RX_HANDLER(IMULH_R) r[ip->dst] = mulh(r[ip->dst], r[ip->src]); RX_NEXT(); \
+    RX_HANDLER(IMULH_M) r[ip->dst] = mulh(r[ip->dst], RX_MEM(ip)); RX_NEXT(); \
+    RX_HANDLER(ISMULH_R) r[ip->dst] = smulh(static_cast<int64_t>(r[ip->dst]), static_cast<int64_t>(r[ip->src])); RX_NEXT(); \
+    RX_HANDLER(ISMULH_M) r[ip->dst] = smulh(static_cast<int64_t>(r[ip->dst]), static_cast<int64_t>(RX_MEM(ip))); RX_NEXT(); \
+    RX_HANDLER(IMUL_RCP) r[ip->dst] *= constants[ip->imm32]; RX_NEXT(); \
+    RX_HANDLER(INEG_R) r[ip->dst] = -r[ip->dst]; RX_NEXT(); \
+    RX_HANDLER(IXOR_R) r[ip->dst] ^= r[ip->src]; RX_NEXT(); \
+    RX_HANDLER(IXOR_M) r[ip->dst] ^= RX_MEM(ip); RX_NEXT(); \
+    RX_HANDLER(IROR_R) r[ip->dst] = rotateRight64(r[ip->dst], r[ip->src] & 63); RX_NEXT(); \
+    RX_HANDLER(IROL_R) r[ip->dst] = rotateLeft64(r[ip->dst], r[ip->src] & 63); RX_NEXT(); \
+    RX_HANDLER(ISWAP_R) std::swap(r[ip->dst], r[ip->src]); RX_NEXT(); \
+    RX_HANDLER(FSWAP_R) std::swap(f[ip->dst], f[ip->src]); RX_NEXT(); \
+    RX_HANDLER(FADD_R) floatAdd(f[ip->dst], f[ip->src]); RX_NEXT(); \
+    RX_HANDLER(FADD_M) floatAdd(f[ip->dst], floatFromMemory(RX_MEM(ip))); RX_NEXT(); \
+    RX_HANDLER(FSUB_R) floatSub(f[ip->dst], f[ip->src]); RX_NEXT(); \
+    RX_HANDLER(FSUB_M) floatSub(f[ip->dst], floatFromMemory(RX_MEM(ip))); RX_NEXT(); \
+    RX_HANDLER(FSCAL_R) floatNegate(f[ip->dst]); RX_NEXT(); \
+    RX_HANDLER(FMUL_R) floatMul(f[ip->dst], f[ip->src]); RX_NEXT(); \
+    RX_HANDLER(FDIV_M) floatDiv(f[ip->dst], floatFromMemory(RX_MEM(ip) | RANDOMX_FDIV_NONZERO_MASK)); RX_NEXT(); \
+    RX_HANDLER(FSQRT_R) floatSqrt(f[ip->dst]); RX_NEXT(); \
+    RX_HANDLER(CBRANCH) branchRegister = (branchRegister + ip->imm32) & RX_MASK(ip); RX_NEXT(); \
+    RX_HANDLER(CFROUND) { \
+        uint32_t mode = static_cast<uint32_t>(rotateRight64(r[ip->src], ip->shift)) & 3; \
+        if (mode != roundingMode) { \
+            setRoundingMode(mode); \
+            roundingMode = mode; \
+        } \
+        RX_NEXT(); \
+    } \
+    RX_HANDLER(ISTORE) scratchpad[RX_ADDRESS(ip, dst) / 8] = r[ip->src]; RX_NEXT(); \
+    RX_HANDLER(NOP) RX_NEXT();
+
+#if RANDOMX_COMPUTED_GOTO
+#define RX_PREFETCH_HANDLER op_PREFETCH:
+#else
+#define RX_PREFETCH_HANDLER case RANDOMX_DECODED_PREFETCH:
+#endif
+
+#define RX_HANDLER_TABLE \
+    static void* const handlers[] = { \
+        &&op_IADD_RS, &&op_IADD_M, &&op_ISUB_R, &&op_ISUB_M, &&op_IMUL_R, &&op_IMUL_M, \
+        &&op_IMULH_R, &&op_IMULH_M, &&op_ISMULH_R, &&op_ISMULH_M, &&op_IMUL_RCP, &&op_INEG_R, \
+        &&op_IXOR_R, &&op_IXOR_M, &&op_IROR_R, &&op_IROL_R, &&op_ISWAP_R, &&op_FSWAP_R, \
+        &&op_FADD_R, &&op_FADD_M, &&op_FSUB_R, &&op_FSUB_M, &&op_FSCAL_R, &&op_FMUL_R, \
+        &&op_FDIV_M, &&op_FSQRT_R, &&op_CBRANCH, &&op_CFROUND, &&op_ISTORE, &&op_NOP, \
+        &&op_PREFETCH, &&op_HALT \
     }
-}
-
-// RandomXVM Implementation
-RandomXVM::RandomXVM() 
-    : m_programCounter(0), m_instructionCount(0), m_cycleCount(0), 
-      m_branchRegister(0), m_branchTarget(0), m_cache(nullptr), 
-      m_lightMode(false), m_initialized(false) {
-    reset();
-}
 
-RandomXVM::~RandomXVM() {
-    destroy();
-}
-
-bool RandomXVM::initialize(RandomXCache* cache, bool lightMode) {
-    if (m_initialized) {
-        return true;
+void RandomXVM::executeThreaded() {
+    prefetchDatasetItem();
+    if (!m_decodedValid) {
+        decodeProgram();
     }
     
-    m_cache = cache;
-    m_lightMode = lightMode;
-    m_initialized = true;
-    
-    return true;
-}
-
-void RandomXVM::destroy() {
-    m_initialized = false;
-    m_cache = nullptr;
-}
-
-void RandomXVM::reset() {
-    std::fill(m_registers.begin(), m_registers.end(), 0);
-    std::fill(m_fregisters.begin(), m_fregisters.end(), 0.0);
-    std::fill(m_scratchpad.begin(), m_scratchpad.end(), 0);
-    std::fill(m_program.begin(), m_program.end(), RandomXInstruction{});
+    uint64_t* r = m_registers.data();
+    RandomXFloatRegister* f = m_fregisters.data();
+    uint64_t* scratchpad = m_scratchpad;
+    const uint64_t* constants = m_decodedConstants.data();
+    uint32_t branchRegister = m_branchRegister;
+    uint32_t roundingMode = m_roundingMode;
+    const RandomXDecodedInstruction* ip = m_decodedProgram.data();
+    
+#if RANDOMX_COMPUTED_GOTO
+    RX_HANDLER_TABLE;
+#define RX_HANDLER(name) op_##name:
+#define RX_NEXT() goto *handlers[(++ip)->opcode]
+    goto *handlers[ip->opcode];
+#else
+#define RX_HANDLER(name) case static_cast<uint8_t>(RandomXInstructionType::name):
+#define RX_NEXT() ++ip; continue
+    for (;;) {
+        switch (ip->opcode) {
+#endif
+    
+    RX_DECODED_HANDLERS
+    
+#if RANDOMX_COMPUTED_GOTO
+    op_HALT:
+#else
+            default:
+                break;
+        }
+        break;
+    }
+#endif
+    
+#undef RX_HANDLER
+#undef RX_NEXT
+    
+    m_branchRegister = branchRegister;
+    m_roundingMode = roundingMode;
+    m_instructionCount += RANDOMX_PROGRAM_SIZE;
+    m_cycleCount += RANDOMX_PROGRAM_SIZE;
+}
+
+// Lockstep engine: the threaded handlers round-robin over up to
+// RANDOMX_MAX_BATCH_SIZE programs, one instruction per lane per step, so the
+// out-of-order core always has independent work from another lane in flight.
+// Each lane keeps its own CFROUND mode; the FPU is only reprogrammed when the
+// next lane's mode differs from the one in effect.
+namespace {
+struct RandomXLockstepLane {
+    uint64_t* r;
+    RandomXFloatRegister* f;
+    uint64_t* scratchpad;
+    const uint64_t* constants;
+    const RandomXDecodedInstruction* ip;
+    uint32_t branchRegister;
+    uint32_t roundingMode;
+    RandomXLockstepLane* next;
+};
+}
+
+void RandomXVM::executeLockstep(RandomXVM* const* vms, size_t count) {
+    if (count == 0) {
+        return;
+    }
     
-    m_programCounter = 0;
-    m_instructionCount = 0;
-    m_cycleCount = 0;
-    m_branchRegister = 0;
-    m_branchTarget = 0;
-}
-
-void RandomXVM::loadProgram(const uint8_t* seed, size_t seedSize) {
-    generateProgram(seed, seedSize);
-}
-
-void RandomXVM::execute() {
-    if (!m_initialized) {
+    // Lockstep only applies to the threaded engine; the interpreter stays the
+    // reference path and JIT code already runs without dispatch overhead
+    bool lockstep = count > 1 && count <= RANDOMX_MAX_BATCH_SIZE;
+    for (size_t i = 0; i < count && lockstep; i++) {
+        lockstep = vms[i]->m_initialized && vms[i]->m_engine == RandomXEngine::THREADED;
+    }
+    if (!lockstep) {
+        // Start every lane's dataset miss before the first program runs
+        for (size_t i = 0; i < count; i++) {
+            vms[i]->prefetchDatasetItem();
+        }
+        for (size_t i = 0; i < count; i++) {
+            vms[i]->execute();
+        }
         return;
     }
     
-    for (int i = 0; i < RANDOMX_PROGRAM_SIZE; i++) {
-        executeInstruction(m_program[i]);
-        m_instructionCount++;
-        m_cycleCount++;
+    RandomXLockstepLane lanes[RANDOMX_MAX_BATCH_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        RandomXVM* vm = vms[i];
+        vm->prefetchDatasetItem();
+        if (!vm->m_decodedValid) {
+            vm->decodeProgram();
+        }
+        lanes[i] = RandomXLockstepLane{vm->m_registers.data(), vm->m_fregisters.data(),
+                                       vm->m_scratchpad, vm->m_decodedConstants.data(),
+                                       vm->m_decodedProgram.data(), vm->m_branchRegister,
+                                       vm->m_roundingMode, nullptr};
     }
-}
-
-uint64_t RandomXVM::getRegister(int index) const {
-    if (index >= 0 && index < 8) {
-        return m_registers[index];
+    
+    // Lanes form a ring; a lane that reaches its halt sentinel is unlinked
+    // (prefetch entries make decoded programs differ in length)
+    for (size_t i = 0; i < count; i++) {
+        lanes[i].next = &lanes[(i + 1) % count];
     }
-    return 0;
-}
-
-void RandomXVM::setRegister(int index, uint64_t value) {
-    if (index >= 0 && index < 8) {
-        m_registers[index] = value;
+    
+    RandomXLockstepLane* lane = lanes;
+    RandomXLockstepLane* previous = lanes + count - 1;
+    uint64_t* r;
+    RandomXFloatRegister* f;
+    uint64_t* scratchpad;
+    const uint64_t* constants;
+    uint32_t branchRegister;
+    uint32_t roundingMode = RANDOMX_ROUNDING_NEAREST;
+    const RandomXDecodedInstruction* ip;
+    
+#define RX_LOAD_LANE() \
+    r = lane->r; \
+    f = lane->f; \
+    scratchpad = lane->scratchpad; \
+    constants = lane->constants; \
+    branchRegister = lane->branchRegister; \
+    if (lane->roundingMode != roundingMode) { \
+        roundingMode = lane->roundingMode; \
+        setRoundingMode(roundingMode); \
+    } \
+    ip = lane->ip
+    
+#define RX_SWITCH_LANE() \
+    lane->ip = ip + 1; \
+    lane->branchRegister = branchRegister; \
+    lane->roundingMode = roundingMode; \
+    previous = lane; \
+    lane = lane->next; \
+    RX_LOAD_LANE()
+    
+    RX_LOAD_LANE();
+    
+#if RANDOMX_COMPUTED_GOTO
+    RX_HANDLER_TABLE;
+#define RX_HANDLER(name) op_##name:
+#define RX_NEXT() RX_SWITCH_LANE(); goto *handlers[ip->opcode]
+    goto *handlers[ip->opcode];
+#else
+#define RX_HANDLER(name) case static_cast<uint8_t>(RandomXInstructionType::name):
+#define RX_NEXT() RX_SWITCH_LANE(); continue
+    for (;;) {
+        switch (ip->opcode) {
+#endif
+    
+    RX_DECODED_HANDLERS
+    
+#if RANDOMX_COMPUTED_GOTO
+    op_HALT:
+#else
+            default:
+#endif
+        lane->branchRegister = branchRegister;
+        if (lane->next == lane) {
+            goto done;
+        }
+        previous->next = lane->next;
+        lane = lane->next;
+        RX_LOAD_LANE();
+#if RANDOMX_COMPUTED_GOTO
+        goto *handlers[ip->opcode];
+#else
+            continue;
+        }
     }
-}
-
-uint64_t RandomXVM::getScratchpad(int index) const {
-    if (index >= 0 && index < 8) {
-        return m_scratchpad[index];
+#endif
+    
+done:
+#undef RX_HANDLER
+#undef RX_NEXT
+#undef RX_SWITCH_LANE
+#undef RX_LOAD_LANE
+    
+    if (roundingMode != RANDOMX_ROUNDING_NEAREST) {
+        setRoundingMode(RANDOMX_ROUNDING_NEAREST);
     }
-    return 0;
-}
-
-void RandomXVM::setScratchpad(int index, uint64_t value) {
-    if (index >= 0 && index < 8) {
-        m_scratchpad[index] = value;
+    for (size_t i = 0; i < count; i++) {
+        vms[i]->m_branchRegister = lanes[i].branchRegister;
+        vms[i]->m_roundingMode = RANDOMX_ROUNDING_NEAREST;
+        vms[i]->m_instructionCount += RANDOMX_PROGRAM_SIZE;
+        vms[i]->m_cycleCount += RANDOMX_PROGRAM_SIZE;
+        vms[i]->mixDatasetItem();
     }
 }
 
-const RandomXInstruction& RandomXVM::getInstruction(int index) const {
-    if (index >= 0 && index < RANDOMX_PROGRAM_SIZE) {
-        return m_program[index];
+#undef RX_HANDLER_TABLE
+#undef RX_PREFETCH_HANDLER
+#undef RX_DECODED_HANDLERS
+#undef RX_MEM
+#undef RX_ADDRESS
+#undef RX_MASK
+
+// JIT engine
+bool RandomXVM::compileJit() {
+    if (!m_jit) {
+        m_jit = std::make_unique<RandomXJitCompiler>();
+        if (!m_jit->initialize()) {
+            LOG_WARNING("RandomX JIT unavailable, falling back to threaded engine");
+            m_engine = RandomXEngine::THREADED;
+            return false;
+        }
     }
-    static RandomXInstruction empty = {};
-    return empty;
+    
+    m_jitValid = m_jit->compile(m_program.data(), RANDOMX_PROGRAM_SIZE,
+                                m_prefetchHints.data(), m_prefetchHintCount);
+    return m_jitValid;
 }
 
-void RandomXVM::setInstruction(int index, const RandomXInstruction& instruction) {
-    if (index >= 0 && index < RANDOMX_PROGRAM_SIZE) {
-        m_program[index] = instruction;
-    }
+void RandomXVM::executeJit() {
+    prefetchDatasetItem();
+    RandomXJitState state;
+    state.registers = m_registers.data();
+    state.fregisters = &m_fregisters[0].lo;
+    state.scratchpad = m_scratchpad;
+    state.branchRegister = m_branchRegister;
+    state.roundingMode = m_roundingMode;
+    
+    m_jit->run(&state);
+    
+    m_branchRegister = state.branchRegister;
+    m_roundingMode = state.roundingMode;
+    m_instructionCount += RANDOMX_PROGRAM_SIZE;
+    m_cycleCount += RANDOMX_PROGRAM_SIZE;
 }
 
 void RandomXVM::executeInstruction(const RandomXInstruction& instruction) {
@@ -306,15 +1784,7 @@ void RandomXVM::executeIADD_RS(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeIADD_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] += value;
 }
@@ -324,15 +1794,7 @@ void RandomXVM::executeISUB_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeISUB_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] -= value;
 }
@@ -342,15 +1804,7 @@ void RandomXVM::executeIMUL_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeIMUL_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] *= value;
 }
@@ -360,15 +1814,7 @@ void RandomXVM::executeIMULH_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeIMULH_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] = mulh(m_registers[instruction.dst], value);
 }
@@ -379,15 +1825,7 @@ void RandomXVM::executeISMULH_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeISMULH_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] = smulh(static_cast<int64_t>(m_registers[instruction.dst]), 
                                         static_cast<int64_t>(value));
@@ -408,15 +1846,7 @@ void RandomXVM::executeIXOR_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeIXOR_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
     m_registers[instruction.dst] ^= value;
 }
@@ -440,68 +1870,42 @@ void RandomXVM::executeFSWAP_R(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeFADD_R(const RandomXInstruction& instruction) {
-    m_fregisters[instruction.dst] += m_fregisters[instruction.src];
+    floatAdd(m_fregisters[instruction.dst], m_fregisters[instruction.src]);
 }
 
 void RandomXVM::executeFADD_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
-    
-    m_fregisters[instruction.dst] += int64ToDouble(value);
+    floatAdd(m_fregisters[instruction.dst], floatFromMemory(value));
 }
 
 void RandomXVM::executeFSUB_R(const RandomXInstruction& instruction) {
-    m_fregisters[instruction.dst] -= m_fregisters[instruction.src];
+    floatSub(m_fregisters[instruction.dst], m_fregisters[instruction.src]);
 }
 
 void RandomXVM::executeFSUB_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
-    
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
-    m_fregisters[instruction.dst] -= int64ToDouble(value);
+    floatSub(m_fregisters[instruction.dst], floatFromMemory(value));
 }
 
 void RandomXVM::executeFSCAL_R(const RandomXInstruction& instruction) {
-    m_fregisters[instruction.dst] = -m_fregisters[instruction.dst];
+    floatNegate(m_fregisters[instruction.dst]);
 }
 
 void RandomXVM::executeFMUL_R(const RandomXInstruction& instruction) {
-    m_fregisters[instruction.dst] *= m_fregisters[instruction.src];
+    floatMul(m_fregisters[instruction.dst], m_fregisters[instruction.src]);
 }
 
 void RandomXVM::executeFDIV_M(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    uint64_t value = 0;
+    uint64_t value = m_scratchpad[getMemoryAddress(instruction) / 8];
     
-    if (m_cache && !m_lightMode) {
-        const RandomXDatasetItem* item = m_cache->getDatasetItem(address / 64);
-        if (item) {
-            value = item->data[(address % 64) / 8];
-        }
-    }
-    
-    double divisor = int64ToDouble(value);
-    if (divisor != 0.0) {
-        m_fregisters[instruction.dst] /= divisor;
-    }
+    // Both divisor lanes are forced odd, so neither can be zero
+    floatDiv(m_fregisters[instruction.dst], floatFromMemory(value | RANDOMX_FDIV_NONZERO_MASK));
 }
 
 void RandomXVM::executeFSQRT_R(const RandomXInstruction& instruction) {
-    m_fregisters[instruction.dst] = std::sqrt(m_fregisters[instruction.dst]);
+    floatSqrt(m_fregisters[instruction.dst]);
 }
 
 void RandomXVM::executeCBRANCH(const RandomXInstruction& instruction) {
@@ -512,13 +1916,16 @@ void RandomXVM::executeCBRANCH(const RandomXInstruction& instruction) {
 }
 
 void RandomXVM::executeCFROUND(const RandomXInstruction& instruction) {
-    // Simplified rounding mode change
-    // In a real implementation, this would change the FPU rounding mode
+    uint32_t mode = static_cast<uint32_t>(rotateRight64(m_registers[instruction.src], instruction.imm32 & 63)) & 3;
+    if (mode != m_roundingMode) {
+        setRoundingMode(mode);
+        m_roundingMode = mode;
+    }
 }
 
 void RandomXVM::executeISTORE(const RandomXInstruction& instruction) {
-    uint32_t address = getMemoryAddress(instruction);
-    m_scratchpad[address % 8] = m_registers[instruction.src];
+    uint32_t address = static_cast<uint32_t>(m_registers[instruction.dst] + instruction.imm32);
+    m_scratchpad[(address & tierMask(instruction.tier)) / 8] = m_registers[instruction.src];
 }
 
 void RandomXVM::executeNOP(const RandomXInstruction& instruction) {
@@ -527,152 +1934,491 @@ void RandomXVM::executeNOP(const RandomXInstruction& instruction) {
 
 // Utility functions
 uint64_t RandomXVM::rotateRight64(uint64_t x, int n) {
-    return (x >> n) | (x << (64 - n));
+    return (x >> n) | (x << ((64 - n) & 63));
+}
+
+uint64_t RandomXVM::rotateLeft64(uint64_t x, int n) {
+    return (x << n) | (x >> ((64 - n) & 63));
+}
+
+uint64_t RandomXVM::mulh(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    // One MUL (x86-64) or UMULH (arm64), both baseline instructions
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFULL;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFULL;
+    uint64_t b_hi = b >> 32;
+    
+    uint64_t p0 = a_lo * b_lo;
+    uint64_t p1 = a_lo * b_hi;
+    uint64_t p2 = a_hi * b_lo;
+    uint64_t p3 = a_hi * b_hi;
+    
+    uint64_t p1_lo = p1 & 0xFFFFFFFFULL;
+    uint64_t p1_hi = p1 >> 32;
+    uint64_t p2_lo = p2 & 0xFFFFFFFFULL;
+    uint64_t p2_hi = p2 >> 32;
+    
+    uint64_t carry = ((p0 >> 32) + p1_lo + p2_lo) >> 32;
+    
+    return p3 + p1_hi + p2_hi + carry;
+#endif
+}
+
+int64_t RandomXVM::smulh(int64_t a, int64_t b) {
+    return static_cast<int64_t>(mulh(static_cast<uint64_t>(a), static_cast<uint64_t>(b)));
+}
+
+double RandomXVM::int64ToDouble(uint64_t x) {
+    return static_cast<double>(static_cast<int64_t>(x));
+}
+
+uint64_t RandomXVM::doubleToInt64(double x) {
+    return static_cast<uint64_t>(static_cast<int64_t>(x));
+}
+
+// Program the current thread's rounding mode; callers skip it when the mode is unchanged
+void RandomXVM::setRoundingMode(uint32_t mode) {
+#if defined(RANDOMX_FLOAT_SSE2)
+    _mm_setcsr((_mm_getcsr() & ~0x6000u) | ((mode & 3) << 13));
+#else
+    static const int modes[4] = {FE_TONEAREST, FE_DOWNWARD, FE_UPWARD, FE_TOWARDZERO};
+    std::fesetround(modes[mode & 3]);
+#endif
+}
+
+// Program generation is one pass: Blake2b-512 of the seed, spread over the AES
+// generator state, whose first 2 KB are the instruction words. Columns 0-3 take
+// the digest as is; later groups of four XOR a per-group constant into it.
+void RandomXVM::generateProgram(const uint8_t* seed, size_t seedSize) {
+    uint64_t digest[RANDOMX_BLAKE2B_MAX_DIGEST / 8];
+    RandomXBlake2b::hash(digest, sizeof(digest), seed, seedSize);
+    
+    // The dataset item is known before execution, like RandomX's ma taken from
+    // the previous iteration, so the engines can prefetch it a whole program ahead
+    constexpr uint32_t itemCount = static_cast<uint32_t>(RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem));
+    m_datasetIndex = static_cast<uint32_t>(digest[2] ^ digest[3]) % itemCount;
+    
+    uint64_t state[RANDOMX_AES_STATE_SIZE / 8];
+    for (size_t word = 0; word < RANDOMX_AES_STATE_SIZE / 8; word++) {
+        state[word] = digest[word % 8] ^ (0x9e3779b97f4a7c15ULL * (word / 8));
+    }
+    std::memcpy(m_aesState, state, sizeof(state));
+    
+    alignas(64) uint64_t words[RANDOMX_PROGRAM_SIZE];
+    RandomXAes::fill(m_aesState, words, sizeof(words));
+    
+    // One variant dispatch per program; the tiers are constants inside the loop
+    visitRandomXVariant(m_variant, [this, &words]<typename Params>() {
+        for (uint32_t pc = 0; pc < RANDOMX_PROGRAM_SIZE; pc++) {
+            RandomXInstruction& instruction = m_program[pc];
+            decodeInstruction(words[pc], instruction);
+            instruction.tier = instructionTier<Params>(instruction);
+        }
+    });
+    m_decodedValid = false;
+    m_jitValid = false;
+}
+
+// Fields are written in place so no temporary is copied per instruction
+void RandomXVM::decodeInstruction(uint64_t word, RandomXInstruction& instruction) {
+    instruction.type = static_cast<RandomXInstructionType>(word % 30);
+    instruction.dst = word & 7;
+    instruction.src = (word >> 8) & 7;
+    instruction.imm32 = static_cast<uint32_t>(word >> 16);
+    instruction.imm64 = word;
+    instruction.mod = (word >> 32) & 7;
+    instruction.modShift = ((word >> 35) & 7) + 1;
+    instruction.modMask = (1ULL << instruction.modShift) - 1;
+}
+
+uint32_t RandomXVM::getRegisterMask(const RandomXInstruction& instruction) {
+    return instruction.modMask;
+}
+
+// Byte offset into the scratchpad, 8-byte aligned and within the operand's tier
+uint32_t RandomXVM::getMemoryAddress(const RandomXInstruction& instruction) {
+    const uint32_t mask = tierMask(instruction.tier);
+    if ((instruction.src & 7) == (instruction.dst & 7)) {
+        return instruction.imm32 & mask;
+    }
+    return static_cast<uint32_t>(m_registers[instruction.src] + instruction.imm32) & mask;
+}
+
+// Main RandomX class implementation
+RandomX::RandomX() 
+    : m_initialized(false), m_lightMode(false), m_engine(RandomXEngine::THREADED),
+      m_variant(RandomXVariant::RX_0), m_batchSize(1), m_prefetchDistance(RANDOMX_DEFAULT_PREFETCH_DISTANCE), m_useHugePages(false), m_numaEnabled(true),
+      m_totalHashes(0), m_validHashes(0), m_threadCount(1),
+      m_nextCacheBuilding(false), m_nextCacheReady(false), m_cacheGeneration(0) {
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+RandomX::~RandomX() {
+    destroy();
+}
+
+bool RandomX::initialize(const uint8_t* key, size_t keySize, bool lightMode, int workerCount) {
+    if (m_initialized) {
+        return true;
+    }
+    
+    m_lightMode = lightMode;
+    LOG_INFO("CPU ISA level {}, features: {}", CpuFeatures::isaLevelToString(CpuFeatures::isaLevel()),
+             CpuFeatures::featureString());
+    LOG_INFO("RandomX kernels: AES {}, Blake2b {}, Argon2d {}, dataset {}, hex {}",
+             RandomXAes::kernelToString(RandomXAes::activeKernel()),
+             RandomXBlake2b::kernelToString(RandomXBlake2b::activeKernel()),
+             RandomXArgon2::kernelToString(RandomXArgon2::activeKernel()),
+             RandomXCache::datasetKernel(), hexKernel());
+    
+    // Create cache
+    // Light mode has no dataset to replicate, so only fast mode spreads across nodes
+    m_numaNodes.clear();
+    if (m_numaEnabled && !lightMode) {
+        std::vector<NumaNode> nodes = CpuTopology::detectNumaNodes();
+        if (nodes.size() > 1) {
+            m_numaNodes = nodes;
+            LOG_INFO("Detected {} NUMA nodes, replicating the RandomX dataset per node", nodes.size());
+        }
+    }
+    
+    m_cache = std::make_shared<RandomXCache>();
+    m_cache->setVariant(m_variant);
+    m_cache->setDatasetCacheDir(m_datasetCacheDir);
+    m_cache->setUseHugePages(m_useHugePages);
+    m_cache->setNumaNodes(m_numaNodes);
+    if (!m_cache->initialize(key, keySize, lightMode)) {
+        m_cache.reset();
+        return false;
+    }
+    
+    // Create one VM per worker lane so hashing threads never share VM state;
+    // worker w owns VMs [w * m_batchSize, (w + 1) * m_batchSize)
+    m_threadCount = workerCount > 0 ? workerCount : static_cast<int>(std::thread::hardware_concurrency());
+    if (m_threadCount <= 0) {
+        m_threadCount = 1;
+    }
+    
+    // Workers take nodes in contiguous blocks: with 2 nodes, the first half uses node 0
+    const size_t nodeCount = getNumaNodeCount();
+    m_workerNode.resize(m_threadCount);
+    for (int worker = 0; worker < m_threadCount; worker++) {
+        m_workerNode[worker] = static_cast<size_t>(worker) * nodeCount / m_threadCount;
+    }
+    m_nodeHashes = std::make_unique<std::atomic<uint64_t>[]>(nodeCount);
+    for (size_t node = 0; node < nodeCount; node++) {
+        m_nodeHashes[node] = 0;
+    }
+    
+    // All scratchpads come from one arena; each 2 MB slice is huge page aligned.
+    // Pages are first touched by the worker filling them, so they land on its node.
+    const size_t vmCount = static_cast<size_t>(m_threadCount) * m_batchSize;
+    m_scratchpadArena = RandomXMemory::allocate(vmCount * RANDOMX_SCRATCHPAD_SIZE, m_useHugePages, "scratchpads");
+    if (!m_scratchpadArena.memory) {
+        LOG_ERROR("Failed to allocate {} RandomX scratchpads", vmCount);
+        return false;
+    }
+    
+    for (size_t i = 0; i < vmCount; i++) {
+        auto vm = std::make_unique<RandomXVM>();
+        uint8_t* scratchpad = static_cast<uint8_t*>(m_scratchpadArena.memory) + i * RANDOMX_SCRATCHPAD_SIZE;
+        if (!vm->initialize(m_cache.get(), lightMode, scratchpad)) {
+            return false;
+        }
+        vm->setEngine(m_engine);
+        vm->setPrefetchDistance(m_prefetchDistance);
+        vm->setNumaNode(m_workerNode[i / m_batchSize]);
+        m_vms.push_back(std::move(vm));
+    }
+    m_workerInUse.assign(m_threadCount, false);
+    m_workerCaches.assign(m_threadCount, m_cache);
+    m_workerGeneration.assign(m_threadCount, m_cacheGeneration.load());
+    
+    m_initialized = true;
+    return true;
+}
+
+bool RandomX::initialize(const uint8_t* key, size_t keySize, MemoryMode mode, int workerCount) {
+    if (mode != MemoryMode::AUTO) {
+        return initialize(key, keySize, mode == MemoryMode::LIGHT, workerCount);
+    }
+    
+    if (initialize(key, keySize, false, workerCount)) {
+        return true;
+    }
+    
+    LOG_WARNING("RandomX fast mode initialization failed, falling back to light mode");
+    return initialize(key, keySize, true, workerCount);
+}
+
+void RandomX::destroy() {
+    if (m_nextCacheThread.joinable()) {
+        m_nextCacheThread.join();
+    }
+    m_nextCache.reset();
+    m_nextCacheBuilding = false;
+    m_nextCacheReady = false;
+    
+    m_vms.clear();
+    RandomXMemory::release(m_scratchpadArena);
+    m_workerInUse.clear();
+    m_workerCaches.clear();
+    m_workerGeneration.clear();
+    m_workerNode.clear();
+    m_workerCpus.clear();
+    m_nodeHashes.reset();
+    m_cache.reset();
+    
+    m_initialized = false;
+}
+
+bool RandomX::prepareNextKey(const uint8_t* key, size_t keySize, int initThreads) {
+    return prepareNextKey(key, keySize, m_variant, initThreads);
 }
 
-uint64_t RandomXVM::rotateLeft64(uint64_t x, int n) {
-    return (x << n) | (x >> (64 - n));
+bool RandomX::prepareNextKey(const uint8_t* key, size_t keySize, RandomXVariant variant, int initThreads) {
+    if (!m_initialized || !key || m_nextCacheBuilding.load()) {
+        return false;
+    }
+    
+    // A finished but never activated build is superseded by the new key
+    if (m_nextCacheThread.joinable()) {
+        m_nextCacheThread.join();
+    }
+    m_nextCache.reset();
+    m_nextCacheReady = false;
+    m_nextCacheBuilding = true;
+    
+    std::vector<uint8_t> keyCopy(key, key + keySize);
+    m_nextCacheThread = std::thread([this, keyCopy = std::move(keyCopy), variant, initThreads]() {
+        auto cache = std::make_shared<RandomXCache>();
+        cache->setVariant(variant);
+        cache->setDatasetCacheDir(m_datasetCacheDir);
+        cache->setUseHugePages(m_useHugePages);
+        cache->setNumaNodes(m_numaNodes);
+        if (cache->initialize(keyCopy.data(), keyCopy.size(), m_lightMode, initThreads)) {
+            m_nextCache = std::move(cache);
+            m_nextCacheReady = true;
+        } else {
+            LOG_ERROR("Failed to build RandomX dataset for the next key");
+        }
+        m_nextCacheBuilding = false;
+    });
+    
+    LOG_INFO("Building RandomX {} {} for the next key in the background", variantToString(variant),
+             m_lightMode ? "cache" : "dataset");
+    return true;
 }
 
-uint64_t RandomXVM::mulh(uint64_t a, uint64_t b) {
-    uint64_t a_lo = a & 0xFFFFFFFFULL;
-    uint64_t a_hi = a >> 32;
-    uint64_t b_lo = b & 0xFFFFFFFFULL;
-    uint64_t b_hi = b >> 32;
+bool RandomX::activateNextKey() {
+    if (!m_initialized || !m_nextCacheReady.load()) {
+        return false;
+    }
     
-    uint64_t p0 = a_lo * b_lo;
-    uint64_t p1 = a_lo * b_hi;
-    uint64_t p2 = a_hi * b_lo;
-    uint64_t p3 = a_hi * b_hi;
+    if (m_nextCacheThread.joinable()) {
+        m_nextCacheThread.join();
+    }
     
-    uint64_t p1_lo = p1 & 0xFFFFFFFFULL;
-    uint64_t p1_hi = p1 >> 32;
-    uint64_t p2_lo = p2 & 0xFFFFFFFFULL;
-    uint64_t p2_hi = p2 >> 32;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_cache = std::move(m_nextCache);
+        m_variant = m_cache->getVariant();
+        m_cacheGeneration.fetch_add(1, std::memory_order_release);
+    }
+    m_nextCacheReady = false;
     
-    uint64_t carry = ((p0 >> 32) + p1_lo + p2_lo) >> 32;
+    // Workers that are not hashing are rebound here; busy ones rebind on their next hash
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    for (size_t i = 0; i < m_workerInUse.size(); i++) {
+        if (!m_workerInUse[i]) {
+            bindWorkerCache(static_cast<int>(i));
+        }
+    }
     
-    return p3 + p1_hi + p2_hi + carry;
+    LOG_INFO("Switched RandomX to the next key ({}, generation {})", variantToString(m_variant),
+             m_cacheGeneration.load());
+    return true;
 }
 
-int64_t RandomXVM::smulh(int64_t a, int64_t b) {
-    return static_cast<int64_t>(mulh(static_cast<uint64_t>(a), static_cast<uint64_t>(b)));
+void RandomX::bindWorkerCache(int workerId) {
+    if (m_workerGeneration[workerId] == m_cacheGeneration.load(std::memory_order_acquire)) {
+        return;
+    }
+    
+    std::shared_ptr<RandomXCache> cache;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        cache = m_cache;
+        generation = m_cacheGeneration.load();
+    }
+    
+    for (size_t lane = 0; lane < m_batchSize; lane++) {
+        getWorkerVM(workerId, lane)->setCache(cache.get());
+    }
+    
+    // Dropping the previous reference frees the old dataset after the last worker moves
+    m_workerCaches[workerId] = std::move(cache);
+    m_workerGeneration[workerId] = generation;
 }
 
-double RandomXVM::int64ToDouble(uint64_t x) {
-    return static_cast<double>(static_cast<int64_t>(x));
+void RandomX::setEngine(RandomXEngine engine) {
+    if (engine == RandomXEngine::JIT && !RandomXJitCompiler::isSupported()) {
+        LOG_WARNING("RandomX JIT is not supported on this architecture, using threaded engine");
+        engine = RandomXEngine::THREADED;
+    }
+    
+    m_engine = engine;
+    for (auto& vm : m_vms) {
+        vm->setEngine(engine);
+    }
 }
 
-uint64_t RandomXVM::doubleToInt64(double x) {
-    return static_cast<uint64_t>(static_cast<int64_t>(x));
+void RandomX::setBatchSize(size_t batchSize) {
+    if (m_initialized) {
+        LOG_WARNING("RandomX batch size must be set before initialization");
+        return;
+    }
+    m_batchSize = std::clamp<size_t>(batchSize, 1, RANDOMX_MAX_BATCH_SIZE);
 }
 
-void RandomXVM::generateProgram(const uint8_t* seed, size_t seedSize) {
-    for (uint32_t i = 0; i < RANDOMX_PROGRAM_SIZE; i++) {
-        m_program[i] = generateInstruction(i, seed, seedSize);
+void RandomX::setPrefetchDistance(uint32_t distance) {
+    m_prefetchDistance = std::min(distance, RANDOMX_MAX_PREFETCH_DISTANCE);
+    for (auto& vm : m_vms) {
+        vm->setPrefetchDistance(m_prefetchDistance);
     }
 }
 
-RandomXInstruction RandomXVM::generateInstruction(uint32_t pc, const uint8_t* seed, size_t seedSize) {
-    RandomXInstruction instruction = {};
-    
-    // Generate instruction type
-    uint64_t hash = 0;
-    for (size_t i = 0; i < seedSize; i++) {
-        hash ^= seed[i] << ((i % 8) * 8);
+MemoryMode RandomX::memoryModeFromString(const std::string& name) {
+    if (name == "fast") {
+        return MemoryMode::FAST;
     }
-    hash ^= pc;
-    
-    // Simple hash function
-    for (int i = 0; i < 4; i++) {
-        hash = hash * 0x9e3779b97f4a7c15ULL;
-        hash ^= hash >> 33;
+    if (name == "light") {
+        return MemoryMode::LIGHT;
     }
-    
-    instruction.type = static_cast<RandomXInstructionType>(hash % 30);
-    instruction.dst = hash & 7;
-    instruction.src = (hash >> 8) & 7;
-    instruction.imm32 = static_cast<uint32_t>(hash >> 16);
-    instruction.imm64 = hash;
-    instruction.mod = (hash >> 32) & 7;
-    instruction.modShift = ((hash >> 35) & 7) + 1;
-    instruction.modMask = (1ULL << instruction.modShift) - 1;
-    
-    return instruction;
+    return MemoryMode::AUTO;
 }
 
-uint32_t RandomXVM::getRegisterMask(const RandomXInstruction& instruction) {
-    return instruction.modMask;
+std::string RandomX::memoryModeToString(MemoryMode mode) {
+    switch (mode) {
+        case MemoryMode::FAST: return "fast";
+        case MemoryMode::LIGHT: return "light";
+        case MemoryMode::AUTO: return "auto";
+    }
+    return "unknown";
 }
 
-uint32_t RandomXVM::getMemoryAddress(const RandomXInstruction& instruction) {
-    uint32_t address = m_registers[instruction.src] + instruction.imm32;
-    return address & instruction.modMask;
+RandomXEngine RandomX::engineFromString(const std::string& name) {
+    if (name == "interpreter") {
+        return RandomXEngine::INTERPRETER;
+    }
+    if (name == "jit") {
+        return RandomXEngine::JIT;
+    }
+    return RandomXEngine::THREADED;
 }
 
-// Main RandomX class implementation
-RandomX::RandomX() 
-    : m_cache(nullptr), m_initialized(false), m_lightMode(false),
-      m_totalHashes(0), m_validHashes(0), m_threadCount(1) {
-    m_startTime = std::chrono::steady_clock::now();
-    m_lastHashTime = m_startTime;
+std::string RandomX::engineToString(RandomXEngine engine) {
+    switch (engine) {
+        case RandomXEngine::INTERPRETER: return "interpreter";
+        case RandomXEngine::THREADED: return "threaded";
+        case RandomXEngine::JIT: return "jit";
+    }
+    return "unknown";
 }
 
-RandomX::~RandomX() {
-    destroy();
+// Pool algo names (rx/0) and the family names used in configs (randomx)
+bool RandomX::variantFromString(const std::string& name, RandomXVariant& variant) {
+    for (RandomXVariant candidate : {RandomXVariant::RX_0, RandomXVariant::RX_WOW, RandomXVariant::RX_ARQ}) {
+        bool matches = visitRandomXVariant(candidate, [&name]<typename Params>() {
+            return name == Params::name || name == Params::family;
+        });
+        if (matches) {
+            variant = candidate;
+            return true;
+        }
+    }
+    return false;
 }
 
-bool RandomX::initialize(const uint8_t* key, size_t keySize, bool lightMode) {
-    if (m_initialized) {
-        return true;
+std::string RandomX::variantToString(RandomXVariant variant) {
+    return visitRandomXVariant(variant, []<typename Params>() { return std::string(Params::name); });
+}
+
+int RandomX::acquireWorker() {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    for (size_t i = 0; i < m_workerInUse.size(); i++) {
+        if (!m_workerInUse[i]) {
+            m_workerInUse[i] = true;
+            return static_cast<int>(i);
+        }
     }
-    
-    m_lightMode = lightMode;
-    
-    // Create cache
-    m_cache = new RandomXCache();
-    if (!m_cache->initialize(key, keySize)) {
-        delete m_cache;
-        m_cache = nullptr;
-        return false;
+    return -1;
+}
+
+void RandomX::releaseWorker(int workerId) {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    if (workerId >= 0 && workerId < static_cast<int>(m_workerInUse.size())) {
+        m_workerInUse[workerId] = false;
     }
-    
-    // Create VMs
-    m_threadCount = std::thread::hardware_concurrency();
-    if (m_threadCount == 0) {
-        m_threadCount = 1;
+}
+
+void RandomX::calculateHash(const uint8_t* input, size_t inputSize, uint8_t* output) {
+    if (!m_initialized) {
+        return;
     }
     
-    for (int i = 0; i < m_threadCount; i++) {
-        auto vm = std::make_unique<RandomXVM>();
-        if (!vm->initialize(m_cache, lightMode)) {
-            return false;
-        }
-        m_vms.push_back(std::move(vm));
+    // Borrow a worker for callers that do not own one
+    int workerId = acquireWorker();
+    while (workerId < 0) {
+        std::this_thread::yield();
+        workerId = acquireWorker();
     }
     
-    m_initialized = true;
-    return true;
+    calculateHash(workerId, input, inputSize, output);
+    releaseWorker(workerId);
 }
 
-void RandomX::destroy() {
-    if (m_cache) {
-        delete m_cache;
-        m_cache = nullptr;
+void RandomX::calculateHash(int workerId, const uint8_t* input, size_t inputSize, uint8_t* output) {
+    if (!m_initialized || workerId < 0 || workerId >= getWorkerCount()) {
+        return;
     }
     
-    m_vms.clear();
-    m_initialized = false;
+    bindWorkerCache(workerId);
+    calculateHashInternal(getWorkerVM(workerId), input, inputSize, output);
+    m_totalHashes.fetch_add(1, std::memory_order_relaxed);
+    m_nodeHashes[m_workerNode[workerId]].fetch_add(1, std::memory_order_relaxed);
 }
 
-void RandomX::calculateHash(const uint8_t* input, size_t inputSize, uint8_t* output) {
-    if (!m_initialized) {
+void RandomX::calculateHashBatch(int workerId, const uint8_t* inputs, size_t inputSize, size_t count, uint8_t* outputs) {
+    if (!m_initialized || workerId < 0 || workerId >= getWorkerCount() || !inputs || !outputs) {
         return;
     }
     
-    calculateHashInternal(input, inputSize, output);
-    m_totalHashes++;
-    m_lastHashTime = std::chrono::steady_clock::now();
+    bindWorkerCache(workerId);
+    for (size_t first = 0; first < count; first += m_batchSize) {
+        size_t lanes = std::min(m_batchSize, count - first);
+        RandomXVM* vms[RANDOMX_MAX_BATCH_SIZE];
+        
+        for (size_t lane = 0; lane < lanes; lane++) {
+            vms[lane] = getWorkerVM(workerId, lane);
+            vms[lane]->reset();
+            vms[lane]->loadProgram(inputs + (first + lane) * inputSize, inputSize);
+        }
+        
+        RandomXVM::executeLockstep(vms, lanes);
+        
+        for (size_t lane = 0; lane < lanes; lane++) {
+            finalizeHash(vms[lane], inputs + (first + lane) * inputSize, inputSize,
+                         outputs + (first + lane) * RANDOMX_HASH_SIZE);
+        }
+    }
+    
+    m_totalHashes.fetch_add(count, std::memory_order_relaxed);
+    m_nodeHashes[m_workerNode[workerId]].fetch_add(count, std::memory_order_relaxed);
 }
 
 bool RandomX::isValidHash(const uint8_t* hash, const uint8_t* target) {
@@ -683,14 +2429,14 @@ bool RandomX::isValidHash(const uint8_t* hash, const uint8_t* target) {
     // Compare hash with target (little-endian)
     for (int i = 31; i >= 0; i--) {
         if (hash[i] < target[i]) {
-            m_validHashes++;
+            m_validHashes.fetch_add(1, std::memory_order_relaxed);
             return true;
         } else if (hash[i] > target[i]) {
             return false;
         }
     }
     
-    m_validHashes++;
+    m_validHashes.fetch_add(1, std::memory_order_relaxed);
     return true;
 }
 
@@ -709,6 +2455,60 @@ double RandomX::getHashRate() const {
     return static_cast<double>(m_totalHashes) / (duration.count() / 1000.0);
 }
 
+int RandomX::getWorkerNumaNode(int workerId) const {
+    if (m_numaNodes.empty() || workerId < 0 || workerId >= static_cast<int>(m_workerNode.size())) {
+        return 0;
+    }
+    return m_numaNodes[m_workerNode[workerId]].id;
+}
+
+bool RandomX::bindThreadToWorker(int workerId) {
+    if (workerId >= 0 && workerId < static_cast<int>(m_workerCpus.size())) {
+        return CpuTopology::pinCurrentThread({m_workerCpus[workerId]});
+    }
+    if (m_numaNodes.empty() || workerId < 0 || workerId >= static_cast<int>(m_workerNode.size())) {
+        return false;
+    }
+    return CpuTopology::pinCurrentThread(m_numaNodes[m_workerNode[workerId]].cpus);
+}
+
+void RandomX::setWorkerCpus(const std::vector<int>& cpus) {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    m_workerCpus = cpus;
+    
+    // A worker reads the dataset replica of the node its CPU belongs to
+    for (size_t worker = 0; worker < m_workerCpus.size() && worker < m_workerNode.size(); worker++) {
+        for (size_t node = 0; node < m_numaNodes.size(); node++) {
+            const auto& nodeCpus = m_numaNodes[node].cpus;
+            if (std::find(nodeCpus.begin(), nodeCpus.end(), m_workerCpus[worker]) != nodeCpus.end()) {
+                m_workerNode[worker] = node;
+                break;
+            }
+        }
+        for (size_t lane = 0; lane < m_batchSize; lane++) {
+            m_vms[worker * m_batchSize + lane]->setNumaNode(m_workerNode[worker]);
+        }
+    }
+}
+
+std::vector<double> RandomX::getNodeHashRates() const {
+    std::vector<double> rates(getNumaNodeCount(), 0.0);
+    if (!m_nodeHashes) {
+        return rates;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - m_startTime).count();
+    if (seconds <= 0.0) {
+        return rates;
+    }
+    
+    for (size_t node = 0; node < rates.size(); node++) {
+        rates[node] = static_cast<double>(m_nodeHashes[node].load(std::memory_order_relaxed)) / seconds;
+    }
+    return rates;
+}
+
 double RandomX::getAcceptanceRate() const {
     if (m_totalHashes == 0) {
         return 0.0;
@@ -717,51 +2517,33 @@ double RandomX::getAcceptanceRate() const {
     return static_cast<double>(m_validHashes) / m_totalHashes;
 }
 
-void RandomX::calculateHashInternal(const uint8_t* input, size_t inputSize, uint8_t* output) {
-    // Use the first VM for hash calculation
-    if (m_vms.empty()) {
-        return;
-    }
-    
-    auto& vm = m_vms[0];
+RandomXVM* RandomX::getWorkerVM(int workerId, size_t lane) const {
+    return m_vms[workerId * m_batchSize + lane].get();
+}
+
+void RandomX::calculateHashInternal(RandomXVM* vm, const uint8_t* input, size_t inputSize, uint8_t* output) {
     vm->reset();
     vm->loadProgram(input, inputSize);
     vm->execute();
     
     // Finalize hash
-    finalizeHash(input, inputSize, output);
+    finalizeHash(vm, input, inputSize, output);
 }
 
-void RandomX::finalizeHash(const uint8_t* input, size_t inputSize, uint8_t* output) {
-    // Simple hash finalization
-    uint64_t hash = 0;
-    
-    // Add register values
-    for (int i = 0; i < 8; i++) {
-        hash ^= m_vms[0]->getRegister(i);
-        hash = hash * 0x9e3779b97f4a7c15ULL;
-    }
-    
-    // Add scratchpad values
+// Blake2b-256 over the final registers, a checksum of the whole scratchpad (so
+// every store counts) and the input
+void RandomX::finalizeHash(const RandomXVM* vm, const uint8_t* input, size_t inputSize, uint8_t* output) {
+    uint64_t state[9];
     for (int i = 0; i < 8; i++) {
-        hash ^= m_vms[0]->getScratchpad(i);
-        hash = hash * 0x9e3779b97f4a7c15ULL;
-    }
-    
-    // Add input
-    for (size_t i = 0; i < inputSize; i++) {
-        hash ^= input[i] << ((i % 8) * 8);
-        hash = hash * 0x9e3779b97f4a7c15ULL;
+        state[i] = vm->getRegister(i);
     }
+    state[8] = memoryChecksum(vm->getScratchpadData(), vm->getScratchpadSize());
     
-    // Output hash
-    for (int i = 0; i < 8; i++) {
-        uint64_t val = hash;
-        for (int j = 0; j < 4; j++) {
-            output[i * 4 + j] = (val >> (j * 8)) & 0xFF;
-        }
-        hash = hash * 0x9e3779b97f4a7c15ULL;
-    }
+    RandomXBlake2bState blake;
+    RandomXBlake2b::init(blake, 32);
+    RandomXBlake2b::update(blake, state, sizeof(state));
+    RandomXBlake2b::update(blake, input, inputSize);
+    RandomXBlake2b::final(blake, output);
 }
 
 double RandomX::benchmark(uint32_t iterations) {
@@ -790,33 +2572,263 @@ double RandomX::benchmark(uint32_t iterations) {
     return static_cast<double>(iterations) / (duration.count() / 1000.0);
 }
 
-// Utility functions
-std::vector<uint8_t> RandomX::hexToBytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        if (i + 1 < hex.length()) {
-            std::string byteString = hex.substr(i, 2);
-            try {
-                uint8_t byte = static_cast<uint8_t>(std::stoul(byteString, nullptr, 16));
-                bytes.push_back(byte);
-            } catch (const std::exception& e) {
-                // Invalid hex character, skip
-                continue;
+double RandomX::benchmarkThreads(int threadCount, uint32_t iterationsPerThread) {
+    if (!m_initialized || threadCount <= 0) {
+        return 0.0;
+    }
+    
+    // Each thread holds its own worker for the whole run, like a mining thread
+    std::vector<int> workers;
+    for (int i = 0; i < threadCount; i++) {
+        int workerId = acquireWorker();
+        if (workerId < 0) {
+            break;
+        }
+        workers.push_back(workerId);
+    }
+    
+    if (workers.empty()) {
+        return 0.0;
+    }
+    
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < workers.size(); t++) {
+        threads.emplace_back([this, &go, t, workerId = workers[t], iterationsPerThread]() {
+            bindThreadToWorker(workerId);
+            uint8_t testInput[32] = {0};
+            uint8_t testOutput[32];
+            testInput[4] = static_cast<uint8_t>(t);
+            
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            
+            for (uint32_t i = 0; i < iterationsPerThread; i++) {
+                *reinterpret_cast<uint32_t*>(testInput) = i;
+                calculateHash(workerId, testInput, sizeof(testInput), testOutput);
             }
+        });
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    for (int workerId : workers) {
+        releaseWorker(workerId);
+    }
+    
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    if (duration.count() == 0) {
+        return 0.0;
+    }
+    
+    return static_cast<double>(iterationsPerThread) * workers.size() / (duration.count() / 1000000.0);
+}
+
+double RandomX::benchmarkEngine(RandomXEngine engine, uint32_t programs) {
+    if (!m_initialized || programs == 0) {
+        return 0.0;
+    }
+    
+    int workerId = acquireWorker();
+    if (workerId < 0) {
+        return 0.0;
+    }
+    
+    RandomXVM* vm = getWorkerVM(workerId);
+    RandomXEngine previousEngine = vm->getEngine();
+    vm->setEngine(engine);
+    
+    // Only execution is timed; each program runs several times to amortize the clock reads
+    constexpr int runsPerProgram = 16;
+    uint8_t testInput[32] = {0};
+    std::chrono::nanoseconds executeTime(0);
+    
+    for (uint32_t i = 0; i < programs; i++) {
+        *reinterpret_cast<uint32_t*>(testInput) = i;
+        vm->reset();
+        vm->loadProgram(testInput, sizeof(testInput));
+        
+        auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < runsPerProgram; run++) {
+            vm->execute();
         }
+        executeTime += std::chrono::steady_clock::now() - start;
     }
     
-    return bytes;
+    vm->setEngine(previousEngine);
+    releaseWorker(workerId);
+    
+    double instructions = static_cast<double>(programs) * runsPerProgram * RANDOMX_PROGRAM_SIZE;
+    return static_cast<double>(executeTime.count()) / instructions;
 }
 
-std::string RandomX::bytesToHex(const uint8_t* bytes, size_t length) {
-    std::ostringstream hex;
-    hex << std::hex << std::setfill('0');
+double RandomX::benchmarkProgramGeneration(uint32_t programs) {
+    if (!m_initialized || programs == 0) {
+        return 0.0;
+    }
     
-    for (size_t i = 0; i < length; i++) {
-        hex << std::setw(2) << static_cast<int>(bytes[i]);
+    int workerId = acquireWorker();
+    if (workerId < 0) {
+        return 0.0;
+    }
+    
+    // A block header sized seed with a changing nonce, as mining produces
+    RandomXVM* vm = getWorkerVM(workerId);
+    uint8_t testInput[76] = {0};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < programs; i++) {
+        std::memcpy(testInput + 39, &i, sizeof(i));
+        vm->generateProgram(testInput, sizeof(testInput));
+    }
+    auto end = std::chrono::steady_clock::now();
+    releaseWorker(workerId);
+    
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    return static_cast<double>(duration.count()) / programs;
+}
+
+double RandomX::benchmarkBatch(size_t batchSize, uint32_t iterations) {
+    if (!m_initialized || batchSize == 0 || batchSize > m_batchSize || iterations == 0) {
+        return 0.0;
+    }
+    
+    int workerId = acquireWorker();
+    if (workerId < 0) {
+        return 0.0;
+    }
+    
+    // Consecutive nonces in a mining-sized blob, as Miner::mineJob hashes them
+    constexpr size_t blobSize = 76;
+    std::vector<uint8_t> inputs(blobSize * batchSize, 0);
+    std::vector<uint8_t> outputs(RANDOMX_HASH_SIZE * batchSize);
+    uint32_t nonce = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i += batchSize) {
+        for (size_t lane = 0; lane < batchSize; lane++, nonce++) {
+            std::memcpy(inputs.data() + lane * blobSize + 39, &nonce, sizeof(nonce));
+        }
+        calculateHashBatch(workerId, inputs.data(), blobSize, batchSize, outputs.data());
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    releaseWorker(workerId);
+    
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    if (duration.count() == 0) {
+        return 0.0;
+    }
+    
+    return static_cast<double>(nonce) / (duration.count() / 1000000.0);
+}
+
+double RandomX::benchmarkDatasetLatency(bool prefetch, uint32_t reads) {
+    if (!m_initialized || !m_cache || m_lightMode || reads == 0) {
+        return 0.0;
+    }
+    
+    // The VM's access pattern: each program's item is known when the program is
+    // generated, prefetched as it starts and read after its last instruction. A
+    // multiply chain of one step per program instruction stands in for the
+    // program, and the word read depends on the running value, so without the
+    // prefetch every miss stalls the chain.
+    constexpr uint32_t itemCount = static_cast<uint32_t>(RANDOMX_DATASET_SIZE / sizeof(RandomXDatasetItem));
+    std::vector<uint32_t> items(reads);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (uint32_t i = 0; i < reads; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        items[i] = static_cast<uint32_t>(state % itemCount);
+    }
+    
+    uint64_t acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < reads; i++) {
+        const RandomXDatasetItem* item = m_cache->getDatasetItem(items[i]);
+        if (prefetch) {
+            prefetchRead(item);
+        }
+        for (int step = 0; step < RANDOMX_PROGRAM_SIZE; step++) {
+            acc = acc * 0x9e3779b97f4a7c15ULL + step;
+        }
+        acc += item->data[acc & 7];
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    // Keep the chain observable so the loop is not optimized away
+    volatile uint64_t sink = acc;
+    (void)sink;
+    
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    return static_cast<double>(duration.count()) / reads;
+}
+
+double RandomX::benchmarkPageLatency(bool useHugePages, RandomXPages& pages, size_t bytes, uint32_t reads) {
+    RandomXMemoryBlock block = RandomXMemory::allocate(bytes, useHugePages, "page latency buffer");
+    pages = block.pages;
+    if (!block.memory || reads == 0) {
+        RandomXMemory::release(block);
+        return 0.0;
+    }
+    
+#if defined(__linux__) && defined(MADV_NOHUGEPAGE)
+    // Keep the baseline on base pages even when THP is set to "always"
+    if (!useHugePages) {
+        madvise(block.memory, block.size, MADV_NOHUGEPAGE);
+    }
+#endif
+    
+    // One random cycle through every cache line (Sattolo), so each load depends
+    // on the previous one and lands on an unpredictable page
+    const size_t lines = bytes / 64;
+    uint64_t* words = static_cast<uint64_t*>(block.memory);
+    std::vector<uint32_t> order(lines);
+    for (size_t i = 0; i < lines; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::mt19937_64 rng(0x9e3779b97f4a7c15ULL);
+    for (size_t i = lines - 1; i > 0; i--) {
+        std::swap(order[i], order[rng() % i]);
+    }
+    for (size_t i = 0; i < lines; i++) {
+        words[static_cast<size_t>(order[i]) * 8] = order[(i + 1) % lines];
     }
     
-    return hex.str();
-}
\ No newline at end of file
+    uint64_t line = order[0];
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < reads; i++) {
+        line = words[line * 8];
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    volatile uint64_t sink = line;
+    (void)sink;
+    RandomXMemory::release(block);
+    
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    return static_cast<double>(duration.count()) / reads;
+}
+
+// Utility functions
+std::vector<uint8_t> RandomX::hexToBytes(const std::string& hex) {
+    std::vector<uint8_t> bytes(hex.length() / 2);
+    bytes.resize(hexCodec().decode(hex.data(), bytes.size(), bytes.data()));
+    return bytes;
+}
+
+std::string RandomX::bytesToHex(const uint8_t* bytes, size_t length) {
+    std::string hex(length * 2, '\0');
+    hexCodec().encode(bytes, length, hex.data());
+    return hex;
+}
+
+std::string RandomX::hexKernel() {
+    return hexCodec().name;
+}
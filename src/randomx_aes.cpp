@@ -0,0 +1,268 @@
+#include "randomx_aes.h"
+#include "cpu_features.h"
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDOMX_AES_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr uint8_t SBOX[256] = {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+    };
+
+    // SubBytes and MixColumns of one byte in row 0: bytes {2s, s, s, 3s} (little-endian);
+    // rows 1-3 use the same entry rotated left by 8, 16 and 24 bits
+    constexpr std::array<uint32_t, 256> makeTable() {
+        std::array<uint32_t, 256> table{};
+        for (int i = 0; i < 256; i++) {
+            uint32_t s = SBOX[i];
+            uint32_t s2 = ((s << 1) ^ ((s >> 7) * 0x1b)) & 0xff;
+            table[i] = s2 | (s << 8) | (s << 16) | ((s2 ^ s) << 24);
+        }
+        return table;
+    }
+    constexpr std::array<uint32_t, 256> TABLE = makeTable();
+
+    // Round key of each column, from splitmix64
+    constexpr std::array<uint64_t, RANDOMX_AES_STATE_SIZE / 8> makeKeys() {
+        std::array<uint64_t, RANDOMX_AES_STATE_SIZE / 8> keys{};
+        uint64_t x = 0x6a09e667f3bcc908ULL;
+        for (auto& key : keys) {
+            x += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }
+    alignas(64) constexpr std::array<uint64_t, RANDOMX_AES_STATE_SIZE / 8> KEYS = makeKeys();
+
+    inline uint32_t rotl32(uint32_t x, int bits) {
+        return (x << bits) | (x >> (32 - bits));
+    }
+
+    inline uint32_t load32(const uint8_t* bytes) {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    // Column c of the output reads row r from input column c + r (ShiftRows)
+    inline void softwareRound(const uint8_t* input, const uint8_t* key, uint8_t* output) {
+        uint32_t columns[4];
+        for (int c = 0; c < 4; c++) {
+            columns[c] = TABLE[input[4 * c]] ^
+                         rotl32(TABLE[input[4 * ((c + 1) & 3) + 1]], 8) ^
+                         rotl32(TABLE[input[4 * ((c + 2) & 3) + 2]], 16) ^
+                         rotl32(TABLE[input[4 * ((c + 3) & 3) + 3]], 24) ^
+                         load32(key + 4 * c);
+        }
+        std::memcpy(output, columns, sizeof(columns));
+    }
+
+    void fillSoftware(uint8_t* state, uint8_t* output, size_t size) {
+        const uint8_t* keys = reinterpret_cast<const uint8_t*>(KEYS.data());
+        alignas(16) uint8_t next[RANDOMX_AES_STATE_SIZE];
+        for (size_t offset = 0; offset < size; offset += RANDOMX_AES_STATE_SIZE) {
+            for (size_t column = 0; column < RANDOMX_AES_STATE_SIZE; column += 16) {
+                softwareRound(state + column, keys + column, next + column);
+            }
+            std::memcpy(state, next, RANDOMX_AES_STATE_SIZE);
+            std::memcpy(output + offset, next, RANDOMX_AES_STATE_SIZE);
+        }
+    }
+
+#if defined(RANDOMX_AES_X86)
+    // Sixteen independent columns hide the AESENC latency
+    __attribute__((target("aes,sse2")))
+    void fillAesni(uint8_t* state, uint8_t* output, size_t size) {
+        const __m128i* keys = reinterpret_cast<const __m128i*>(KEYS.data());
+        __m128i columns[16];
+        for (int c = 0; c < 16; c++) {
+            columns[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state) + c);
+        }
+        for (size_t offset = 0; offset < size; offset += RANDOMX_AES_STATE_SIZE) {
+            __m128i* out = reinterpret_cast<__m128i*>(output + offset);
+#pragma GCC unroll 16
+            for (int c = 0; c < 16; c++) {
+                columns[c] = _mm_aesenc_si128(columns[c], _mm_load_si128(keys + c));
+                _mm_storeu_si128(out + c, columns[c]);
+            }
+        }
+        for (int c = 0; c < 16; c++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state) + c, columns[c]);
+        }
+    }
+
+    __attribute__((target("vaes,avx512f")))
+    void fillVaes(uint8_t* state, uint8_t* output, size_t size) {
+        const __m512i* keys = reinterpret_cast<const __m512i*>(KEYS.data());
+        const __m512i k0 = _mm512_load_si512(keys + 0);
+        const __m512i k1 = _mm512_load_si512(keys + 1);
+        const __m512i k2 = _mm512_load_si512(keys + 2);
+        const __m512i k3 = _mm512_load_si512(keys + 3);
+        __m512i c0 = _mm512_loadu_si512(state + 0);
+        __m512i c1 = _mm512_loadu_si512(state + 64);
+        __m512i c2 = _mm512_loadu_si512(state + 128);
+        __m512i c3 = _mm512_loadu_si512(state + 192);
+        for (size_t offset = 0; offset < size; offset += RANDOMX_AES_STATE_SIZE) {
+            c0 = _mm512_aesenc_epi128(c0, k0);
+            c1 = _mm512_aesenc_epi128(c1, k1);
+            c2 = _mm512_aesenc_epi128(c2, k2);
+            c3 = _mm512_aesenc_epi128(c3, k3);
+            _mm512_storeu_si512(output + offset + 0, c0);
+            _mm512_storeu_si512(output + offset + 64, c1);
+            _mm512_storeu_si512(output + offset + 128, c2);
+            _mm512_storeu_si512(output + offset + 192, c3);
+        }
+        _mm512_storeu_si512(state + 0, c0);
+        _mm512_storeu_si512(state + 64, c1);
+        _mm512_storeu_si512(state + 128, c2);
+        _mm512_storeu_si512(state + 192, c3);
+    }
+
+    __attribute__((target("aes,sse2")))
+    void roundAesni(const uint8_t* input, const uint8_t* key, uint8_t* output) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_aesenc_si128(x, k));
+    }
+
+    __attribute__((target("vaes,avx512f")))
+    void roundVaes(const uint8_t* input, const uint8_t* key, uint8_t* output) {
+        __m512i x = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)));
+        __m512i k = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm512_castsi512_si128(_mm512_aesenc_epi128(x, k)));
+    }
+#endif
+
+    using FillFunction = void (*)(uint8_t*, uint8_t*, size_t);
+
+    FillFunction fillFunction(RandomXAesKernel kernel) {
+        switch (kernel) {
+#if defined(RANDOMX_AES_X86)
+            case RandomXAesKernel::AESNI:
+                return fillAesni;
+            case RandomXAesKernel::VAES:
+                return fillVaes;
+#endif
+            default:
+                return fillSoftware;
+        }
+    }
+}
+
+const std::vector<RandomXAesKernel>& RandomXAes::supportedKernels() {
+    static const std::vector<RandomXAesKernel> kernels = [] {
+        std::vector<RandomXAesKernel> detected = {RandomXAesKernel::SOFTWARE};
+#if defined(RANDOMX_AES_X86)
+        if (CpuFeatures::detect().aes) {
+            detected.push_back(RandomXAesKernel::AESNI);
+        }
+        if (CpuFeatures::detect().vaes) {
+            detected.push_back(RandomXAesKernel::VAES);
+        }
+#endif
+        return detected;
+    }();
+    return kernels;
+}
+
+bool RandomXAes::isSupported(RandomXAesKernel kernel) {
+    for (RandomXAesKernel supported : supportedKernels()) {
+        if (supported == kernel) {
+            return true;
+        }
+    }
+    return false;
+}
+
+RandomXAesKernel RandomXAes::activeKernel() {
+    static const RandomXAesKernel kernel = supportedKernels().back();
+    return kernel;
+}
+
+std::string RandomXAes::kernelToString(RandomXAesKernel kernel) {
+    switch (kernel) {
+        case RandomXAesKernel::SOFTWARE: return "software";
+        case RandomXAesKernel::AESNI: return "aes-ni";
+        case RandomXAesKernel::VAES: return "vaes-avx512";
+    }
+    return "unknown";
+}
+
+void RandomXAes::encryptRound(RandomXAesKernel kernel, const uint8_t input[16], const uint8_t key[16], uint8_t output[16]) {
+#if defined(RANDOMX_AES_X86)
+    if (kernel == RandomXAesKernel::AESNI && isSupported(kernel)) {
+        roundAesni(input, key, output);
+        return;
+    }
+    if (kernel == RandomXAesKernel::VAES && isSupported(kernel)) {
+        roundVaes(input, key, output);
+        return;
+    }
+#endif
+    (void)kernel;
+    softwareRound(input, key, output);
+}
+
+void RandomXAes::fill(uint8_t state[RANDOMX_AES_STATE_SIZE], void* output, size_t size) {
+    static const FillFunction function = fillFunction(activeKernel());
+    function(state, static_cast<uint8_t*>(output), size);
+}
+
+void RandomXAes::fill(RandomXAesKernel kernel, uint8_t state[RANDOMX_AES_STATE_SIZE], void* output, size_t size) {
+    FillFunction function = isSupported(kernel) ? fillFunction(kernel) : fillSoftware;
+    function(state, static_cast<uint8_t*>(output), size);
+}
+
+double RandomXAes::benchmark(RandomXAesKernel kernel, size_t bufferSize, uint32_t repeats) {
+    bufferSize -= bufferSize % RANDOMX_AES_STATE_SIZE;
+    if (bufferSize == 0 || repeats == 0 || !isSupported(kernel)) {
+        return 0.0;
+    }
+
+    void* buffer = std::aligned_alloc(64, bufferSize);
+    if (!buffer) {
+        return 0.0;
+    }
+
+    alignas(64) uint8_t state[RANDOMX_AES_STATE_SIZE];
+    for (size_t i = 0; i < sizeof(state); i++) {
+        state[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+
+    // One untimed pass faults the buffer in and warms the caches
+    fill(kernel, state, buffer, bufferSize);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < repeats; i++) {
+        fill(kernel, state, buffer, bufferSize);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::free(buffer);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0.0 ? static_cast<double>(bufferSize) * repeats / seconds / 1e9 : 0.0;
+}
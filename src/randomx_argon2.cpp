@@ -0,0 +1,594 @@
+#include "randomx_argon2.h"
+#include "randomx_blake2b.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <barrier>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDOMX_ARGON2_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr size_t BLOCK_WORDS = RANDOMX_ARGON2_BLOCK_SIZE / 8;
+    constexpr uint32_t SYNC_POINTS = 4;
+
+    struct alignas(64) Block {
+        uint64_t words[BLOCK_WORDS];
+    };
+
+    // next = G(prev, ref), or next ^= G(prev, ref) when overwriting a later pass
+    using CompressFunction = void (*)(const Block* prev, const Block* ref, Block* next, bool withXor);
+
+    inline uint64_t rotr64(uint64_t x, int bits) {
+        return (x >> bits) | (x << (64 - bits));
+    }
+
+    // BlaMka: Blake2b's addition plus twice the product of the low halves
+    inline uint64_t blamka(uint64_t x, uint64_t y) {
+        return x + y + 2 * (x & 0xffffffffULL) * (y & 0xffffffffULL);
+    }
+
+    inline void gScalar(uint64_t& a, uint64_t& b, uint64_t& c, uint64_t& d) {
+        a = blamka(a, b);
+        d = rotr64(d ^ a, 32);
+        c = blamka(c, d);
+        b = rotr64(b ^ c, 24);
+        a = blamka(a, b);
+        d = rotr64(d ^ a, 16);
+        c = blamka(c, d);
+        b = rotr64(b ^ c, 63);
+    }
+
+    // The permutation P over sixteen words picked out of the block by index
+    inline void roundScalar(uint64_t* q, const int* v) {
+        gScalar(q[v[0]], q[v[4]], q[v[8]],  q[v[12]]);
+        gScalar(q[v[1]], q[v[5]], q[v[9]],  q[v[13]]);
+        gScalar(q[v[2]], q[v[6]], q[v[10]], q[v[14]]);
+        gScalar(q[v[3]], q[v[7]], q[v[11]], q[v[15]]);
+        gScalar(q[v[0]], q[v[5]], q[v[10]], q[v[15]]);
+        gScalar(q[v[1]], q[v[6]], q[v[11]], q[v[12]]);
+        gScalar(q[v[2]], q[v[7]], q[v[8]],  q[v[13]]);
+        gScalar(q[v[3]], q[v[4]], q[v[9]],  q[v[14]]);
+    }
+
+    // G: P over each row of 16 words, then over each column of 2-word pairs
+    void compressScalar(const Block* prev, const Block* ref, Block* next, bool withXor) {
+        uint64_t r[BLOCK_WORDS];
+        uint64_t q[BLOCK_WORDS];
+        for (size_t i = 0; i < BLOCK_WORDS; i++) {
+            r[i] = prev->words[i] ^ ref->words[i];
+            q[i] = r[i];
+        }
+
+        int v[16];
+        for (int row = 0; row < 8; row++) {
+            for (int i = 0; i < 16; i++) {
+                v[i] = 16 * row + i;
+            }
+            roundScalar(q, v);
+        }
+        for (int column = 0; column < 8; column++) {
+            for (int i = 0; i < 8; i++) {
+                v[2 * i] = 2 * column + 16 * i;
+                v[2 * i + 1] = 2 * column + 16 * i + 1;
+            }
+            roundScalar(q, v);
+        }
+
+        for (size_t i = 0; i < BLOCK_WORDS; i++) {
+            uint64_t value = q[i] ^ r[i];
+            next->words[i] = withXor ? next->words[i] ^ value : value;
+        }
+    }
+
+#if defined(RANDOMX_ARGON2_X86)
+    // SSE2: each 4-word row of the 4x4 matrix is two __m128i, (x0, x1)
+    inline __m128i blamkaSse2(__m128i x, __m128i y) {
+        __m128i product = _mm_mul_epu32(x, y);
+        return _mm_add_epi64(_mm_add_epi64(x, y), _mm_add_epi64(product, product));
+    }
+
+    template <int bits>
+    inline __m128i rotrSse2(__m128i x) {
+        if constexpr (bits == 32) {
+            return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+        } else if constexpr (bits == 63) {
+            return _mm_xor_si128(_mm_srli_epi64(x, 63), _mm_add_epi64(x, x));
+        } else {
+            return _mm_xor_si128(_mm_srli_epi64(x, bits), _mm_slli_epi64(x, 64 - bits));
+        }
+    }
+
+    inline void gSse2(__m128i& a0, __m128i& b0, __m128i& c0, __m128i& d0,
+                      __m128i& a1, __m128i& b1, __m128i& c1, __m128i& d1) {
+        a0 = blamkaSse2(a0, b0);
+        a1 = blamkaSse2(a1, b1);
+        d0 = rotrSse2<32>(_mm_xor_si128(d0, a0));
+        d1 = rotrSse2<32>(_mm_xor_si128(d1, a1));
+        c0 = blamkaSse2(c0, d0);
+        c1 = blamkaSse2(c1, d1);
+        b0 = rotrSse2<24>(_mm_xor_si128(b0, c0));
+        b1 = rotrSse2<24>(_mm_xor_si128(b1, c1));
+        a0 = blamkaSse2(a0, b0);
+        a1 = blamkaSse2(a1, b1);
+        d0 = rotrSse2<16>(_mm_xor_si128(d0, a0));
+        d1 = rotrSse2<16>(_mm_xor_si128(d1, a1));
+        c0 = blamkaSse2(c0, d0);
+        c1 = blamkaSse2(c1, d1);
+        b0 = rotrSse2<63>(_mm_xor_si128(b0, c0));
+        b1 = rotrSse2<63>(_mm_xor_si128(b1, c1));
+    }
+
+    // Rows b, c, d rotate left by 1, 2, 3 words so the diagonals become columns
+    inline void roundSse2(__m128i& a0, __m128i& a1, __m128i& b0, __m128i& b1,
+                          __m128i& c0, __m128i& c1, __m128i& d0, __m128i& d1) {
+        gSse2(a0, b0, c0, d0, a1, b1, c1, d1);
+
+        __m128i t0 = d0;
+        __m128i t1 = b0;
+        std::swap(c0, c1);
+        d0 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(t0, t0));
+        d1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(d1, d1));
+        b0 = _mm_unpackhi_epi64(b0, _mm_unpacklo_epi64(b1, b1));
+        b1 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(t1, t1));
+
+        gSse2(a0, b0, c0, d0, a1, b1, c1, d1);
+
+        t0 = b0;
+        t1 = d0;
+        std::swap(c0, c1);
+        b0 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(b0, b0));
+        b1 = _mm_unpackhi_epi64(t0, _mm_unpacklo_epi64(b1, b1));
+        d0 = _mm_unpackhi_epi64(d0, _mm_unpacklo_epi64(d1, d1));
+        d1 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(t1, t1));
+    }
+
+    void compressSse2(const Block* prev, const Block* ref, Block* next, bool withXor) {
+        const __m128i* x = reinterpret_cast<const __m128i*>(prev->words);
+        const __m128i* y = reinterpret_cast<const __m128i*>(ref->words);
+        __m128i r[64];
+        __m128i q[64];
+        for (int i = 0; i < 64; i++) {
+            r[i] = _mm_xor_si128(_mm_load_si128(x + i), _mm_load_si128(y + i));
+            q[i] = r[i];
+        }
+
+        // Row i is q[8i..8i+7]; column i is q[i], q[8 + i], ..., q[56 + i]
+        for (int i = 0; i < 8; i++) {
+            roundSse2(q[8 * i + 0], q[8 * i + 1], q[8 * i + 2], q[8 * i + 3],
+                      q[8 * i + 4], q[8 * i + 5], q[8 * i + 6], q[8 * i + 7]);
+        }
+        for (int i = 0; i < 8; i++) {
+            roundSse2(q[i], q[8 + i], q[16 + i], q[24 + i], q[32 + i], q[40 + i], q[48 + i], q[56 + i]);
+        }
+
+        __m128i* out = reinterpret_cast<__m128i*>(next->words);
+        for (int i = 0; i < 64; i++) {
+            __m128i value = _mm_xor_si128(q[i], r[i]);
+            _mm_store_si128(out + i, withXor ? _mm_xor_si128(_mm_load_si128(out + i), value) : value);
+        }
+    }
+
+    // AVX2: each 4-word row of the matrix is one __m256i; two matrices at a time
+    __attribute__((target("avx2")))
+    inline __m256i blamkaAvx2(__m256i x, __m256i y) {
+        __m256i product = _mm256_mul_epu32(x, y);
+        return _mm256_add_epi64(_mm256_add_epi64(x, y), _mm256_add_epi64(product, product));
+    }
+
+    __attribute__((target("avx2")))
+    inline void gAvx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+        const __m256i rotate24 = _mm256_setr_epi8(
+            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+        const __m256i rotate16 = _mm256_setr_epi8(
+            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+        a = blamkaAvx2(a, b);
+        d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+        c = blamkaAvx2(c, d);
+        b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotate24);
+        a = blamkaAvx2(a, b);
+        d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotate16);
+        c = blamkaAvx2(c, d);
+        b = _mm256_xor_si256(b, c);
+        b = _mm256_xor_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+    }
+
+    __attribute__((target("avx2")))
+    inline void roundAvx2(__m256i& a0, __m256i& b0, __m256i& c0, __m256i& d0,
+                          __m256i& a1, __m256i& b1, __m256i& c1, __m256i& d1) {
+        gAvx2(a0, b0, c0, d0);
+        gAvx2(a1, b1, c1, d1);
+        b0 = _mm256_permute4x64_epi64(b0, _MM_SHUFFLE(0, 3, 2, 1));
+        c0 = _mm256_permute4x64_epi64(c0, _MM_SHUFFLE(1, 0, 3, 2));
+        d0 = _mm256_permute4x64_epi64(d0, _MM_SHUFFLE(2, 1, 0, 3));
+        b1 = _mm256_permute4x64_epi64(b1, _MM_SHUFFLE(0, 3, 2, 1));
+        c1 = _mm256_permute4x64_epi64(c1, _MM_SHUFFLE(1, 0, 3, 2));
+        d1 = _mm256_permute4x64_epi64(d1, _MM_SHUFFLE(2, 1, 0, 3));
+        gAvx2(a0, b0, c0, d0);
+        gAvx2(a1, b1, c1, d1);
+        b0 = _mm256_permute4x64_epi64(b0, _MM_SHUFFLE(2, 1, 0, 3));
+        c0 = _mm256_permute4x64_epi64(c0, _MM_SHUFFLE(1, 0, 3, 2));
+        d0 = _mm256_permute4x64_epi64(d0, _MM_SHUFFLE(0, 3, 2, 1));
+        b1 = _mm256_permute4x64_epi64(b1, _MM_SHUFFLE(2, 1, 0, 3));
+        c1 = _mm256_permute4x64_epi64(c1, _MM_SHUFFLE(1, 0, 3, 2));
+        d1 = _mm256_permute4x64_epi64(d1, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    __attribute__((target("avx2")))
+    void compressAvx2(const Block* prev, const Block* ref, Block* next, bool withXor) {
+        const __m256i* x = reinterpret_cast<const __m256i*>(prev->words);
+        const __m256i* y = reinterpret_cast<const __m256i*>(ref->words);
+        __m256i r[32];
+        __m256i q[32];
+        for (int i = 0; i < 32; i++) {
+            r[i] = _mm256_xor_si256(_mm256_load_si256(x + i), _mm256_load_si256(y + i));
+            q[i] = r[i];
+        }
+
+        // Row i is q[4i..4i+3]
+        for (int i = 0; i < 8; i += 2) {
+            roundAvx2(q[4 * i], q[4 * i + 1], q[4 * i + 2], q[4 * i + 3],
+                      q[4 * i + 4], q[4 * i + 5], q[4 * i + 6], q[4 * i + 7]);
+        }
+
+        // Columns 2j and 2j + 1 are the low and high halves of q[j], q[4 + j], ..., q[28 + j]
+        for (int j = 0; j < 4; j++) {
+            __m256i low[4];
+            __m256i high[4];
+            for (int k = 0; k < 4; k++) {
+                low[k] = _mm256_permute2x128_si256(q[8 * k + j], q[8 * k + 4 + j], 0x20);
+                high[k] = _mm256_permute2x128_si256(q[8 * k + j], q[8 * k + 4 + j], 0x31);
+            }
+            roundAvx2(low[0], low[1], low[2], low[3], high[0], high[1], high[2], high[3]);
+            for (int k = 0; k < 4; k++) {
+                q[8 * k + j] = _mm256_permute2x128_si256(low[k], high[k], 0x20);
+                q[8 * k + 4 + j] = _mm256_permute2x128_si256(low[k], high[k], 0x31);
+            }
+        }
+
+        __m256i* out = reinterpret_cast<__m256i*>(next->words);
+        for (int i = 0; i < 32; i++) {
+            __m256i value = _mm256_xor_si256(q[i], r[i]);
+            _mm256_store_si256(out + i, withXor ? _mm256_xor_si256(_mm256_load_si256(out + i), value) : value);
+        }
+    }
+
+    // AVX-512: each 256-bit half of a register is one matrix row, so one call runs
+    // two matrices and the lane permutes diagonalize both halves at once
+    __attribute__((target("avx512f")))
+    inline __m512i blamkaAvx512(__m512i x, __m512i y) {
+        __m512i product = _mm512_mul_epu32(x, y);
+        return _mm512_add_epi64(_mm512_add_epi64(x, y), _mm512_add_epi64(product, product));
+    }
+
+    __attribute__((target("avx512f")))
+    inline void gAvx512(__m512i& a, __m512i& b, __m512i& c, __m512i& d) {
+        a = blamkaAvx512(a, b);
+        d = _mm512_ror_epi64(_mm512_xor_si512(d, a), 32);
+        c = blamkaAvx512(c, d);
+        b = _mm512_ror_epi64(_mm512_xor_si512(b, c), 24);
+        a = blamkaAvx512(a, b);
+        d = _mm512_ror_epi64(_mm512_xor_si512(d, a), 16);
+        c = blamkaAvx512(c, d);
+        b = _mm512_ror_epi64(_mm512_xor_si512(b, c), 63);
+    }
+
+    __attribute__((target("avx512f")))
+    inline void roundAvx512(__m512i& a, __m512i& b, __m512i& c, __m512i& d) {
+        gAvx512(a, b, c, d);
+        b = _mm512_permutex_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm512_permutex_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm512_permutex_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+        gAvx512(a, b, c, d);
+        b = _mm512_permutex_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm512_permutex_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm512_permutex_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    __attribute__((target("avx512f")))
+    void compressAvx512(const Block* prev, const Block* ref, Block* next, bool withXor) {
+        const __m512i* x = reinterpret_cast<const __m512i*>(prev->words);
+        const __m512i* y = reinterpret_cast<const __m512i*>(ref->words);
+        __m512i r[16];
+        __m512i q[16];
+        for (int i = 0; i < 16; i++) {
+            r[i] = _mm512_xor_si512(_mm512_load_si512(x + i), _mm512_load_si512(y + i));
+            q[i] = r[i];
+        }
+
+        // Row i is q[2i] (a | b) and q[2i + 1] (c | d); rows i and i + 1 share registers
+        for (int i = 0; i < 8; i += 2) {
+            __m512i a = _mm512_shuffle_i64x2(q[2 * i], q[2 * i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            __m512i b = _mm512_shuffle_i64x2(q[2 * i], q[2 * i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            __m512i c = _mm512_shuffle_i64x2(q[2 * i + 1], q[2 * i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            __m512i d = _mm512_shuffle_i64x2(q[2 * i + 1], q[2 * i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+            roundAvx512(a, b, c, d);
+            q[2 * i] = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+            q[2 * i + 2] = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(3, 2, 3, 2));
+            q[2 * i + 1] = _mm512_shuffle_i64x2(c, d, _MM_SHUFFLE(1, 0, 1, 0));
+            q[2 * i + 3] = _mm512_shuffle_i64x2(c, d, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        // Column 4g + l takes 128-bit lane l of q[g], q[2 + g], ..., q[14 + g];
+        // columns (4g, 4g + 1) and (4g + 2, 4g + 3) share registers
+        const __m512i pick01 = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+        const __m512i pick23 = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+        const __m512i evenLanes = _mm512_setr_epi64(0, 1, 4, 5, 8, 9, 12, 13);
+        const __m512i oddLanes = _mm512_setr_epi64(2, 3, 6, 7, 10, 11, 14, 15);
+        for (int g = 0; g < 2; g++) {
+            __m512i rows01[4];
+            __m512i rows23[4];
+            for (int k = 0; k < 4; k++) {
+                rows01[k] = _mm512_permutex2var_epi64(q[4 * k + g], pick01, q[4 * k + 2 + g]);
+                rows23[k] = _mm512_permutex2var_epi64(q[4 * k + g], pick23, q[4 * k + 2 + g]);
+            }
+            roundAvx512(rows01[0], rows01[1], rows01[2], rows01[3]);
+            roundAvx512(rows23[0], rows23[1], rows23[2], rows23[3]);
+            for (int k = 0; k < 4; k++) {
+                q[4 * k + g] = _mm512_permutex2var_epi64(rows01[k], evenLanes, rows23[k]);
+                q[4 * k + 2 + g] = _mm512_permutex2var_epi64(rows01[k], oddLanes, rows23[k]);
+            }
+        }
+
+        __m512i* out = reinterpret_cast<__m512i*>(next->words);
+        for (int i = 0; i < 16; i++) {
+            __m512i value = _mm512_xor_si512(q[i], r[i]);
+            _mm512_store_si512(out + i, withXor ? _mm512_xor_si512(_mm512_load_si512(out + i), value) : value);
+        }
+    }
+#endif
+
+    CompressFunction compressFunction(RandomXArgon2Kernel kernel) {
+        switch (kernel) {
+#if defined(RANDOMX_ARGON2_X86)
+            case RandomXArgon2Kernel::SSE2:
+                return compressSse2;
+            case RandomXArgon2Kernel::AVX2:
+                return compressAvx2;
+            case RandomXArgon2Kernel::AVX512:
+                return compressAvx512;
+#endif
+            default:
+                return compressScalar;
+        }
+    }
+
+    void store32(uint8_t* bytes, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void update32(RandomXBlake2bState& state, uint32_t value) {
+        uint8_t bytes[4];
+        store32(bytes, value);
+        RandomXBlake2b::update(state, bytes, sizeof(bytes));
+    }
+
+    // H' (RFC 9106 3.3): Blake2b extended to digests longer than 64 bytes
+    void hashLong(uint8_t* output, uint32_t outputSize, const uint8_t* input, size_t inputSize) {
+        RandomXBlake2bState state;
+        RandomXBlake2b::init(state, std::min<uint32_t>(outputSize, RANDOMX_BLAKE2B_MAX_DIGEST));
+        update32(state, outputSize);
+        RandomXBlake2b::update(state, input, inputSize);
+        if (outputSize <= RANDOMX_BLAKE2B_MAX_DIGEST) {
+            RandomXBlake2b::final(state, output);
+            return;
+        }
+
+        // 32 bytes of each chained 64-byte digest, and all of the last one
+        uint8_t digest[RANDOMX_BLAKE2B_MAX_DIGEST];
+        RandomXBlake2b::final(state, digest);
+        std::memcpy(output, digest, 32);
+        output += 32;
+        outputSize -= 32;
+        while (outputSize > RANDOMX_BLAKE2B_MAX_DIGEST) {
+            RandomXBlake2b::hash(digest, sizeof(digest), digest, sizeof(digest));
+            std::memcpy(output, digest, 32);
+            output += 32;
+            outputSize -= 32;
+        }
+        RandomXBlake2b::hash(output, outputSize, digest, sizeof(digest));
+    }
+
+    struct Instance {
+        Block* blocks;
+        uint32_t passes;
+        uint32_t lanes;
+        uint32_t laneLength;
+        uint32_t segmentLength;
+        CompressFunction compress;
+    };
+
+    // Position of the reference block within its lane (RFC 9106 3.4.1.2)
+    uint32_t referenceIndex(const Instance& instance, uint32_t pass, uint32_t slice, uint32_t index,
+                            uint32_t pseudoRandom, bool sameLane) {
+        // Blocks of finished segments, plus this segment's own when in the same lane
+        uint32_t finished = pass == 0 ? slice * instance.segmentLength : instance.laneLength - instance.segmentLength;
+        uint32_t areaSize = sameLane ? finished + index - 1 : finished - (index == 0 ? 1 : 0);
+
+        uint64_t relative = (static_cast<uint64_t>(pseudoRandom) * pseudoRandom) >> 32;
+        relative = areaSize - 1 - ((static_cast<uint64_t>(areaSize) * relative) >> 32);
+        uint32_t start = (pass == 0 || slice == SYNC_POINTS - 1) ? 0 : (slice + 1) * instance.segmentLength;
+        return static_cast<uint32_t>((start + relative) % instance.laneLength);
+    }
+
+    void fillSegment(const Instance& instance, uint32_t pass, uint32_t lane, uint32_t slice) {
+        uint32_t startIndex = (pass == 0 && slice == 0) ? 2 : 0;
+        size_t laneStart = static_cast<size_t>(lane) * instance.laneLength;
+        for (uint32_t index = startIndex; index < instance.segmentLength; index++) {
+            uint32_t column = slice * instance.segmentLength + index;
+            const Block* prev = &instance.blocks[laneStart + (column == 0 ? instance.laneLength - 1 : column - 1)];
+
+            // Argon2d: data-dependent addressing from the first word of the previous block
+            uint64_t pseudoRandom = prev->words[0];
+            uint32_t refLane = (pass == 0 && slice == 0) ? lane : static_cast<uint32_t>((pseudoRandom >> 32) % instance.lanes);
+            uint32_t refIndex = referenceIndex(instance, pass, slice, index, static_cast<uint32_t>(pseudoRandom),
+                                               refLane == lane);
+            const Block* ref = &instance.blocks[static_cast<size_t>(refLane) * instance.laneLength + refIndex];
+
+            instance.compress(prev, ref, &instance.blocks[laneStart + column], pass > 0);
+        }
+    }
+}
+
+const std::vector<RandomXArgon2Kernel>& RandomXArgon2::supportedKernels() {
+    static const std::vector<RandomXArgon2Kernel> kernels = [] {
+        std::vector<RandomXArgon2Kernel> detected = {RandomXArgon2Kernel::SCALAR};
+#if defined(RANDOMX_ARGON2_X86)
+        const CpuFeatureSet& features = CpuFeatures::detect();
+        if (features.sse2) {
+            detected.push_back(RandomXArgon2Kernel::SSE2);
+        }
+        if (features.avx2) {
+            detected.push_back(RandomXArgon2Kernel::AVX2);
+        }
+        if (features.avx512f) {
+            detected.push_back(RandomXArgon2Kernel::AVX512);
+        }
+#endif
+        return detected;
+    }();
+    return kernels;
+}
+
+bool RandomXArgon2::isSupported(RandomXArgon2Kernel kernel) {
+    const std::vector<RandomXArgon2Kernel>& kernels = supportedKernels();
+    return std::find(kernels.begin(), kernels.end(), kernel) != kernels.end();
+}
+
+RandomXArgon2Kernel RandomXArgon2::activeKernel() {
+    static const RandomXArgon2Kernel kernel = supportedKernels().back();
+    return kernel;
+}
+
+std::string RandomXArgon2::kernelToString(RandomXArgon2Kernel kernel) {
+    switch (kernel) {
+        case RandomXArgon2Kernel::SCALAR: return "scalar";
+        case RandomXArgon2Kernel::SSE2: return "sse2";
+        case RandomXArgon2Kernel::AVX2: return "avx2";
+        case RandomXArgon2Kernel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+size_t RandomXArgon2::blockCount(const RandomXArgon2Params& params) {
+    if (params.lanes == 0 || params.passes == 0 || params.memoryKiB < 8 * params.lanes) {
+        return 0;
+    }
+    uint32_t perSlice = params.memoryKiB / (SYNC_POINTS * params.lanes);
+    return static_cast<size_t>(perSlice) * SYNC_POINTS * params.lanes;
+}
+
+bool RandomXArgon2::fillMemory(void* memory, const RandomXArgon2Params& params, int threads) {
+    return fillMemory(memory, params, threads, activeKernel());
+}
+
+bool RandomXArgon2::fillMemory(void* memory, const RandomXArgon2Params& params, int threads, RandomXArgon2Kernel kernel) {
+    const size_t blocks = blockCount(params);
+    if (!memory || blocks == 0 || reinterpret_cast<uintptr_t>(memory) % 64 != 0) {
+        return false;
+    }
+
+    Instance instance;
+    instance.blocks = static_cast<Block*>(memory);
+    instance.passes = params.passes;
+    instance.lanes = params.lanes;
+    instance.laneLength = static_cast<uint32_t>(blocks / params.lanes);
+    instance.segmentLength = instance.laneLength / SYNC_POINTS;
+    instance.compress = compressFunction(isSupported(kernel) ? kernel : RandomXArgon2Kernel::SCALAR);
+
+    // H0 over every parameter and input, each variable field length-prefixed
+    RandomXBlake2bState state;
+    RandomXBlake2b::init(state, RANDOMX_BLAKE2B_MAX_DIGEST);
+    update32(state, params.lanes);
+    update32(state, params.tagSize);
+    update32(state, params.memoryKiB);
+    update32(state, params.passes);
+    update32(state, RANDOMX_ARGON2_VERSION);
+    update32(state, 0);  // type: Argon2d
+    const std::pair<const uint8_t*, size_t> fields[] = {
+        {params.password, params.passwordSize}, {params.salt, params.saltSize},
+        {params.secret, params.secretSize}, {params.associatedData, params.associatedDataSize}
+    };
+    for (const auto& [data, size] : fields) {
+        update32(state, static_cast<uint32_t>(size));
+        if (size > 0) {
+            RandomXBlake2b::update(state, data, size);
+        }
+    }
+    uint8_t seed[RANDOMX_BLAKE2B_MAX_DIGEST + 8];
+    RandomXBlake2b::final(state, seed);
+
+    // The first two blocks of each lane come from H0, the lane and the column
+    for (uint32_t lane = 0; lane < params.lanes; lane++) {
+        for (uint32_t column = 0; column < 2; column++) {
+            store32(seed + RANDOMX_BLAKE2B_MAX_DIGEST, column);
+            store32(seed + RANDOMX_BLAKE2B_MAX_DIGEST + 4, lane);
+            Block* block = &instance.blocks[static_cast<size_t>(lane) * instance.laneLength + column];
+            hashLong(reinterpret_cast<uint8_t*>(block->words), RANDOMX_ARGON2_BLOCK_SIZE, seed, sizeof(seed));
+        }
+    }
+
+    if (threads <= 0) {
+        threads = static_cast<int>(params.lanes);
+    }
+    threads = std::clamp(threads, 1, static_cast<int>(params.lanes));
+
+    // Thread t fills lanes t, t + threads, ...; all meet at the end of every slice
+    std::barrier sliceDone(threads);
+    auto fillLanes = [&instance, &sliceDone, threads](uint32_t first) {
+        for (uint32_t pass = 0; pass < instance.passes; pass++) {
+            for (uint32_t slice = 0; slice < SYNC_POINTS; slice++) {
+                for (uint32_t lane = first; lane < instance.lanes; lane += threads) {
+                    fillSegment(instance, pass, lane, slice);
+                }
+                sliceDone.arrive_and_wait();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int thread = 1; thread < threads; thread++) {
+        workers.emplace_back(fillLanes, static_cast<uint32_t>(thread));
+    }
+    fillLanes(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return true;
+}
+
+bool RandomXArgon2::hash(void* tag, const RandomXArgon2Params& params, RandomXArgon2Kernel kernel) {
+    const size_t blocks = blockCount(params);
+    if (!tag || blocks == 0 || params.tagSize < 4) {
+        return false;
+    }
+
+    Block* memory = static_cast<Block*>(std::aligned_alloc(64, blocks * sizeof(Block)));
+    if (!memory) {
+        return false;
+    }
+    bool filled = fillMemory(memory, params, static_cast<int>(params.lanes), kernel);
+
+    // Tag: H' over the XOR of each lane's last block
+    if (filled) {
+        const size_t laneLength = blocks / params.lanes;
+        Block last = memory[laneLength - 1];
+        for (uint32_t lane = 1; lane < params.lanes; lane++) {
+            for (size_t i = 0; i < BLOCK_WORDS; i++) {
+                last.words[i] ^= memory[lane * laneLength + laneLength - 1].words[i];
+            }
+        }
+        hashLong(static_cast<uint8_t*>(tag), params.tagSize, reinterpret_cast<const uint8_t*>(last.words),
+                 sizeof(last.words));
+    }
+    std::free(memory);
+    return filled;
+}
@@ -0,0 +1,299 @@
+#include "randomx_blake2b.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDOMX_BLAKE2B_X86 1
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
+
+namespace {
+    constexpr uint64_t IV[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    constexpr uint8_t SIGMA[12][16] = {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+        {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+        {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+        { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+        { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+        { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+        {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+        {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+        { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+        {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0},
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+        {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3}
+    };
+
+    using CompressFunction = void (*)(uint64_t* h, const uint8_t* block, uint64_t t0, uint64_t t1, bool last);
+
+    inline uint64_t rotr64(uint64_t x, int bits) {
+        return (x >> bits) | (x << (64 - bits));
+    }
+
+    void compressScalar(uint64_t* h, const uint8_t* block, uint64_t t0, uint64_t t1, bool last) {
+        uint64_t m[16];
+        std::memcpy(m, block, sizeof(m));
+
+        uint64_t v[16];
+        for (int i = 0; i < 8; i++) {
+            v[i] = h[i];
+            v[i + 8] = IV[i];
+        }
+        v[12] ^= t0;
+        v[13] ^= t1;
+        if (last) {
+            v[14] = ~v[14];
+        }
+
+        auto g = [&v](int a, int b, int c, int d, uint64_t x, uint64_t y) {
+            v[a] = v[a] + v[b] + x;
+            v[d] = rotr64(v[d] ^ v[a], 32);
+            v[c] = v[c] + v[d];
+            v[b] = rotr64(v[b] ^ v[c], 24);
+            v[a] = v[a] + v[b] + y;
+            v[d] = rotr64(v[d] ^ v[a], 16);
+            v[c] = v[c] + v[d];
+            v[b] = rotr64(v[b] ^ v[c], 63);
+        };
+
+        for (int round = 0; round < 12; round++) {
+            const uint8_t* s = SIGMA[round];
+            g(0, 4,  8, 12, m[s[0]],  m[s[1]]);
+            g(1, 5,  9, 13, m[s[2]],  m[s[3]]);
+            g(2, 6, 10, 14, m[s[4]],  m[s[5]]);
+            g(3, 7, 11, 15, m[s[6]],  m[s[7]]);
+            g(0, 5, 10, 15, m[s[8]],  m[s[9]]);
+            g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(2, 7,  8, 13, m[s[12]], m[s[13]]);
+            g(3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (int i = 0; i < 8; i++) {
+            h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+
+#if defined(RANDOMX_BLAKE2B_X86)
+    // G on all four columns (or diagonals) at once
+    __attribute__((target("avx2"))) inline void g4(__m256i& a, __m256i& b, __m256i& c, __m256i& d,
+                                                    __m256i x, __m256i y, __m256i rotate24, __m256i rotate16) {
+        a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+        d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+        c = _mm256_add_epi64(c, d);
+        b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotate24);
+        a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+        d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotate16);
+        c = _mm256_add_epi64(c, d);
+        b = _mm256_xor_si256(b, c);
+        b = _mm256_or_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+    }
+
+    // Rows a-d of the working matrix are one __m256i each, so the four column
+    // G functions run in parallel; rotating rows b-d lines up the diagonals
+    __attribute__((target("avx2")))
+    void compressAvx2(uint64_t* h, const uint8_t* block, uint64_t t0, uint64_t t1, bool last) {
+        uint64_t m[16];
+        std::memcpy(m, block, sizeof(m));
+
+        const __m256i rotate24 = _mm256_setr_epi8(
+            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+            3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+        const __m256i rotate16 = _mm256_setr_epi8(
+            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+            2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+
+        const __m256i h0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h));
+        const __m256i h1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + 4));
+        __m256i a = h0;
+        __m256i b = h1;
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(IV));
+        __m256i d = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(IV + 4)),
+                                     _mm256_set_epi64x(0, last ? -1 : 0, static_cast<int64_t>(t1), static_cast<int64_t>(t0)));
+
+        for (int round = 0; round < 12; round++) {
+            const uint8_t* s = SIGMA[round];
+            g4(a, b, c, d, _mm256_set_epi64x(m[s[6]], m[s[4]], m[s[2]], m[s[0]]),
+               _mm256_set_epi64x(m[s[7]], m[s[5]], m[s[3]], m[s[1]]), rotate24, rotate16);
+
+            b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+            c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+            d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+            g4(a, b, c, d, _mm256_set_epi64x(m[s[14]], m[s[12]], m[s[10]], m[s[8]]),
+               _mm256_set_epi64x(m[s[15]], m[s[13]], m[s[11]], m[s[9]]), rotate24, rotate16);
+            b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+            c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+            d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(h), _mm256_xor_si256(h0, _mm256_xor_si256(a, c)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(h + 4), _mm256_xor_si256(h1, _mm256_xor_si256(b, d)));
+    }
+#endif
+
+    CompressFunction compressFunction(RandomXBlake2bKernel kernel) {
+#if defined(RANDOMX_BLAKE2B_X86)
+        if (kernel == RandomXBlake2bKernel::AVX2) {
+            return compressAvx2;
+        }
+#endif
+        (void)kernel;
+        return compressScalar;
+    }
+
+    void compress(RandomXBlake2bState& state, const uint8_t* block, bool last) {
+        compressFunction(state.kernel)(state.h, block, state.t[0], state.t[1], last);
+    }
+
+    void addCounter(RandomXBlake2bState& state, size_t bytes) {
+        state.t[0] += bytes;
+        if (state.t[0] < bytes) {
+            state.t[1]++;
+        }
+    }
+}
+
+const std::vector<RandomXBlake2bKernel>& RandomXBlake2b::supportedKernels() {
+    static const std::vector<RandomXBlake2bKernel> kernels = [] {
+        std::vector<RandomXBlake2bKernel> detected = {RandomXBlake2bKernel::SCALAR};
+#if defined(RANDOMX_BLAKE2B_X86)
+        if (CpuFeatures::detect().avx2) {
+            detected.push_back(RandomXBlake2bKernel::AVX2);
+        }
+#endif
+        return detected;
+    }();
+    return kernels;
+}
+
+bool RandomXBlake2b::isSupported(RandomXBlake2bKernel kernel) {
+    const std::vector<RandomXBlake2bKernel>& kernels = supportedKernels();
+    return std::find(kernels.begin(), kernels.end(), kernel) != kernels.end();
+}
+
+RandomXBlake2bKernel RandomXBlake2b::activeKernel() {
+    static const RandomXBlake2bKernel kernel = supportedKernels().back();
+    return kernel;
+}
+
+std::string RandomXBlake2b::kernelToString(RandomXBlake2bKernel kernel) {
+    switch (kernel) {
+        case RandomXBlake2bKernel::SCALAR: return "scalar";
+        case RandomXBlake2bKernel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+bool RandomXBlake2b::init(RandomXBlake2bState& state, size_t digestSize) {
+    return init(state, digestSize, activeKernel());
+}
+
+bool RandomXBlake2b::init(RandomXBlake2bState& state, size_t digestSize, RandomXBlake2bKernel kernel) {
+    if (digestSize == 0 || digestSize > RANDOMX_BLAKE2B_MAX_DIGEST) {
+        return false;
+    }
+
+    // Parameter block: digest length, no key, fanout 1, depth 1
+    std::memcpy(state.h, IV, sizeof(state.h));
+    state.h[0] ^= 0x01010000ULL ^ digestSize;
+    state.t[0] = 0;
+    state.t[1] = 0;
+    state.bufferSize = 0;
+    state.digestSize = digestSize;
+    state.kernel = isSupported(kernel) ? kernel : RandomXBlake2bKernel::SCALAR;
+    return true;
+}
+
+void RandomXBlake2b::update(RandomXBlake2bState& state, const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+
+    // The last block is held back: it must be compressed with the final flag
+    while (size > 0) {
+        if (state.bufferSize == RANDOMX_BLAKE2B_BLOCK_SIZE) {
+            addCounter(state, RANDOMX_BLAKE2B_BLOCK_SIZE);
+            compress(state, state.buffer, false);
+            state.bufferSize = 0;
+        }
+        if (state.bufferSize == 0) {
+            while (size > RANDOMX_BLAKE2B_BLOCK_SIZE) {
+                addCounter(state, RANDOMX_BLAKE2B_BLOCK_SIZE);
+                compress(state, input, false);
+                input += RANDOMX_BLAKE2B_BLOCK_SIZE;
+                size -= RANDOMX_BLAKE2B_BLOCK_SIZE;
+            }
+        }
+        size_t take = std::min(size, RANDOMX_BLAKE2B_BLOCK_SIZE - state.bufferSize);
+        std::memcpy(state.buffer + state.bufferSize, input, take);
+        state.bufferSize += take;
+        input += take;
+        size -= take;
+    }
+}
+
+void RandomXBlake2b::final(RandomXBlake2bState& state, void* digest) {
+    addCounter(state, state.bufferSize);
+    std::memset(state.buffer + state.bufferSize, 0, RANDOMX_BLAKE2B_BLOCK_SIZE - state.bufferSize);
+    compress(state, state.buffer, true);
+
+    uint8_t bytes[RANDOMX_BLAKE2B_MAX_DIGEST];
+    std::memcpy(bytes, state.h, sizeof(bytes));
+    std::memcpy(digest, bytes, state.digestSize);
+}
+
+bool RandomXBlake2b::hash(void* digest, size_t digestSize, const void* data, size_t size) {
+    RandomXBlake2bState state;
+    if (!init(state, digestSize)) {
+        return false;
+    }
+    update(state, data, size);
+    final(state, digest);
+    return true;
+}
+
+double RandomXBlake2b::benchmark(RandomXBlake2bKernel kernel, size_t messageSize, uint32_t iterations) {
+    if (messageSize == 0 || iterations == 0 || !isSupported(kernel)) {
+        return 0.0;
+    }
+
+    std::vector<uint8_t> message(messageSize);
+    for (size_t i = 0; i < messageSize; i++) {
+        message[i] = static_cast<uint8_t>(i * 13 + 5);
+    }
+
+    uint8_t digest[RANDOMX_BLAKE2B_MAX_DIGEST];
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        // Chain each digest into the next message so no call can be skipped
+        RandomXBlake2bState state;
+        init(state, RANDOMX_BLAKE2B_MAX_DIGEST, kernel);
+        update(state, message.data(), messageSize);
+        final(state, digest);
+        message[0] ^= digest[0];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+    return nanoseconds / (static_cast<double>(messageSize) * iterations);
+}
+
+double RandomXBlake2b::cyclesPerNanosecond() {
+#if defined(RANDOMX_BLAKE2B_X86)
+    static const double ratio = [] {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t ticks = __rdtsc();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+        }
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(__rdtsc() - ticks) / nanoseconds;
+    }();
+    return ratio;
+#else
+    return 0.0;
+#endif
+}
@@ -0,0 +1,521 @@
+#include "randomx_jit.h"
+#include "randomx.h"
+#include "logger.h"
+#include <cstring>
+
+// The generated code follows the SysV ABI (argument in rdi, xmm6-xmm15 and
+// rsi/rdi not preserved), so Win64 builds take the stub below
+#if defined(__x86_64__) && !defined(_WIN32)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    // x86-64 register numbers
+    constexpr int RAX = 0;
+    constexpr int RCX = 1;
+    constexpr int RDX = 2;
+    constexpr int RBX = 3;
+    constexpr int RSP = 4;
+    constexpr int RBP = 5;
+    constexpr int RSI = 6;
+    constexpr int RDI = 7;
+    constexpr int XMM_TEMP = 8;
+
+    // Code buffer size (a 256-instruction program compiles to well under 16 KiB)
+    constexpr size_t JIT_BUFFER_SIZE = 64 * 1024;
+    constexpr size_t JIT_MAX_INSTRUCTION_SIZE = 48;
+
+    // VM register rN lives in x86 register r(8+N), fN in xmmN
+    inline int vmRegister(uint8_t index) {
+        return 8 + (index & 7);
+    }
+}
+
+RandomXJitCompiler::RandomXJitCompiler()
+    : m_writeView(nullptr), m_execView(nullptr), m_capacity(0), m_codeSize(0),
+      m_dualMapped(false), m_compiled(false), m_cursor(nullptr) {
+}
+
+RandomXJitCompiler::~RandomXJitCompiler() {
+    destroy();
+}
+
+bool RandomXJitCompiler::isSupported() {
+    return true;
+}
+
+bool RandomXJitCompiler::initialize() {
+    if (m_execView) {
+        return true;
+    }
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    // Preferred: two views of one memfd so no page is ever writable and executable,
+    // and recompiling a program needs no syscalls
+    int fd = memfd_create("randomx-jit", MFD_CLOEXEC);
+    if (fd >= 0) {
+        if (ftruncate(fd, JIT_BUFFER_SIZE) == 0) {
+            void* rw = mmap(nullptr, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            void* rx = mmap(nullptr, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+            if (rw != MAP_FAILED && rx != MAP_FAILED) {
+                close(fd);
+                m_writeView = static_cast<uint8_t*>(rw);
+                m_execView = static_cast<uint8_t*>(rx);
+                m_capacity = JIT_BUFFER_SIZE;
+                m_dualMapped = true;
+                return true;
+            }
+            if (rw != MAP_FAILED) munmap(rw, JIT_BUFFER_SIZE);
+            if (rx != MAP_FAILED) munmap(rx, JIT_BUFFER_SIZE);
+        }
+        close(fd);
+    }
+#endif
+
+    // Fallback: one mapping flipped between RW and RX around each compile
+    void* code = mmap(nullptr, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        LOG_WARNING("RandomX JIT: failed to map code buffer");
+        return false;
+    }
+    if (mprotect(code, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC) != 0) {
+        LOG_WARNING("RandomX JIT: executable mappings are not permitted");
+        munmap(code, JIT_BUFFER_SIZE);
+        return false;
+    }
+
+    m_writeView = static_cast<uint8_t*>(code);
+    m_execView = static_cast<uint8_t*>(code);
+    m_capacity = JIT_BUFFER_SIZE;
+    m_dualMapped = false;
+    return true;
+}
+
+void RandomXJitCompiler::destroy() {
+    if (m_execView) {
+        munmap(m_execView, m_capacity);
+    }
+    if (m_dualMapped && m_writeView) {
+        munmap(m_writeView, m_capacity);
+    }
+    m_writeView = nullptr;
+    m_execView = nullptr;
+    m_capacity = 0;
+    m_codeSize = 0;
+    m_compiled = false;
+}
+
+bool RandomXJitCompiler::beginWrite() {
+    if (!m_dualMapped && mprotect(m_writeView, m_capacity, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+    m_cursor = m_writeView;
+    return true;
+}
+
+bool RandomXJitCompiler::endWrite() {
+    m_codeSize = static_cast<size_t>(m_cursor - m_writeView);
+    if (!m_dualMapped && mprotect(m_writeView, m_capacity, PROT_READ | PROT_EXEC) != 0) {
+        return false;
+    }
+    return true;
+}
+
+bool RandomXJitCompiler::compile(const RandomXInstruction* program, size_t count,
+                                 const RandomXPrefetchHint* hints, size_t hintCount) {
+    m_compiled = false;
+    if (!m_execView || !program || (hintCount && !hints)) {
+        return false;
+    }
+    if ((count + hintCount) * JIT_MAX_INSTRUCTION_SIZE + 256 > m_capacity) {
+        return false;
+    }
+
+    if (!beginWrite()) {
+        return false;
+    }
+
+    emitPrologue();
+    size_t hint = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (; hint < hintCount && hints[hint].issue == i; hint++) {
+            if (hints[hint].target < count) {
+                emitPrefetch(program[hints[hint].target]);
+            }
+        }
+        emitInstruction(program[i]);
+    }
+    emitEpilogue();
+
+    m_compiled = endWrite();
+    return m_compiled;
+}
+
+void RandomXJitCompiler::run(RandomXJitState* state) const {
+    if (!m_compiled) {
+        return;
+    }
+    reinterpret_cast<void (*)(RandomXJitState*)>(m_execView)(state);
+}
+
+// Encoding helpers
+void RandomXJitCompiler::emit8(uint8_t byte) {
+    *m_cursor++ = byte;
+}
+
+void RandomXJitCompiler::emit32(uint32_t value) {
+    std::memcpy(m_cursor, &value, sizeof(value));
+    m_cursor += sizeof(value);
+}
+
+void RandomXJitCompiler::emit64(uint64_t value) {
+    std::memcpy(m_cursor, &value, sizeof(value));
+    m_cursor += sizeof(value);
+}
+
+void RandomXJitCompiler::emitRex(bool wide, int reg, int index, int base) {
+    uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg >> 3) & 1) << 2 | ((index >> 3) & 1) << 1 | ((base >> 3) & 1);
+    if (rex != 0x40) {
+        emit8(rex);
+    }
+}
+
+void RandomXJitCompiler::emitModRM(int mod, int reg, int rm) {
+    emit8(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
+}
+
+// op r/m64, r64 (register form)
+void RandomXJitCompiler::emitRegReg(uint8_t opcode, int rm, int reg) {
+    emitRex(true, reg, 0, rm);
+    emit8(opcode);
+    emitModRM(3, reg, rm);
+}
+
+// op r64, [rsi + rax] with a one- or two-byte (0F-prefixed) opcode
+void RandomXJitCompiler::emitRegMem(uint8_t prefix, bool wide, bool twoByte, uint8_t opcode, int reg) {
+    if (prefix) {
+        emit8(prefix);
+    }
+    emitRex(wide, reg, RAX, RSI);
+    if (twoByte) {
+        emit8(0x0F);
+    }
+    emit8(opcode);
+    emitModRM(0, reg, RSP);      // SIB follows
+    emit8(0x06);                 // scale 1, index rax, base rsi
+}
+
+// SSE op xmm, xmm (prefix selects the packed or scalar form)
+void RandomXJitCompiler::emitSse(uint8_t prefix, uint8_t opcode, int reg, int rm) {
+    emit8(prefix);
+    emitRex(false, reg, 0, rm);
+    emit8(0x0F);
+    emit8(opcode);
+    emitModRM(3, reg, rm);
+}
+
+// mov r64, [base + disp8] / mov [base + disp8], r64
+void RandomXJitCompiler::emitLoad(int reg, int base, uint8_t disp) {
+    emitRex(true, reg, 0, base);
+    emit8(0x8B);
+    emitModRM(1, reg, base);
+    emit8(disp);
+}
+
+void RandomXJitCompiler::emitStore(int base, uint8_t disp, int reg) {
+    emitRex(true, reg, 0, base);
+    emit8(0x89);
+    emitModRM(1, reg, base);
+    emit8(disp);
+}
+
+// eax = (uint32_t)(src + imm32) & mask
+void RandomXJitCompiler::emitAddress(int src, uint32_t imm32, uint32_t mask) {
+    emitRex(false, RAX, 0, src);
+    emit8(0x8D);                 // lea eax, [src + disp32]
+    if ((src & 7) == RSP) {
+        emitModRM(2, RAX, RSP);
+        emit8(0x24);             // r12 base needs a SIB byte
+    } else {
+        emitModRM(2, RAX, src);
+    }
+    emit32(imm32);
+    emit8(0x25);                 // and eax, imm32
+    emit32(mask);
+}
+
+// eax = scratchpad offset of a memory operand, in the tier generation stored with it
+void RandomXJitCompiler::emitLoadAddress(const RandomXInstruction& instruction) {
+    const uint32_t mask = RandomXVM::tierMask(instruction.tier);
+    if ((instruction.src & 7) == (instruction.dst & 7)) {
+        emit8(0xB8);             // mov eax, imm32
+        emit32(instruction.imm32 & mask);
+        return;
+    }
+    emitAddress(vmRegister(instruction.src), instruction.imm32, mask);
+}
+
+// prefetcht0 [rsi + address of a later memory operand]
+void RandomXJitCompiler::emitPrefetch(const RandomXInstruction& instruction) {
+    emitLoadAddress(instruction);
+    emitRegMem(0, false, true, 0x18, 1);
+}
+
+void RandomXJitCompiler::emitPrologue() {
+    // Save callee-saved registers used by the program
+    emit8(0x53);                         // push rbx
+    emit8(0x41); emit8(0x54);            // push r12
+    emit8(0x41); emit8(0x55);            // push r13
+    emit8(0x41); emit8(0x56);            // push r14
+    emit8(0x41); emit8(0x57);            // push r15
+
+    // rdi = RandomXJitState*
+    emitLoad(RAX, RDI, offsetof(RandomXJitState, registers));
+    for (int i = 0; i < 8; i++) {
+        emitLoad(vmRegister(i), RAX, static_cast<uint8_t>(i * 8));
+    }
+
+    emitLoad(RAX, RDI, offsetof(RandomXJitState, fregisters));
+    for (int i = 0; i < 8; i++) {
+        emit8(0x66); emit8(0x0F); emit8(0x28);   // movapd xmmI, [rax + 16*i]
+        emitModRM(1, i, RAX);
+        emit8(static_cast<uint8_t>(i * 16));
+    }
+
+    emit8(0x0F); emit8(0xAE);                    // stmxcsr [rdi + mxcsr]
+    emitModRM(1, 3, RDI);
+    emit8(offsetof(RandomXJitState, mxcsr));
+
+    emitLoad(RSI, RDI, offsetof(RandomXJitState, scratchpad));
+    emit8(0x8B);                                 // mov ebx, [rdi + branchRegister]
+    emitModRM(1, RBX, RDI);
+    emit8(offsetof(RandomXJitState, branchRegister));
+}
+
+void RandomXJitCompiler::emitEpilogue() {
+    emitLoad(RAX, RDI, offsetof(RandomXJitState, registers));
+    for (int i = 0; i < 8; i++) {
+        emitStore(RAX, static_cast<uint8_t>(i * 8), vmRegister(i));
+    }
+
+    emitLoad(RAX, RDI, offsetof(RandomXJitState, fregisters));
+    for (int i = 0; i < 8; i++) {
+        emit8(0x66); emit8(0x0F); emit8(0x29);   // movapd [rax + 16*i], xmmI
+        emitModRM(1, i, RAX);
+        emit8(static_cast<uint8_t>(i * 16));
+    }
+
+    emit8(0x89);                                 // mov [rdi + branchRegister], ebx
+    emitModRM(1, RBX, RDI);
+    emit8(offsetof(RandomXJitState, branchRegister));
+
+    emit8(0x41); emit8(0x5F);            // pop r15
+    emit8(0x41); emit8(0x5E);            // pop r14
+    emit8(0x41); emit8(0x5D);            // pop r13
+    emit8(0x41); emit8(0x5C);            // pop r12
+    emit8(0x5B);                         // pop rbx
+    emit8(0xC3);                         // ret
+}
+
+// Each case mirrors the matching RandomXVM::executeXXX handler bit for bit
+void RandomXJitCompiler::emitInstruction(const RandomXInstruction& instruction) {
+    const int dst = vmRegister(instruction.dst);
+    const int src = vmRegister(instruction.src);
+    const int fdst = instruction.dst & 7;
+    const int fsrc = instruction.src & 7;
+
+    switch (instruction.type) {
+        case RandomXInstructionType::IADD_RS:
+            emitRegReg(0x89, RAX, src);                      // mov rax, src
+            emitRex(true, 0, 0, RAX);
+            emit8(0xC1); emitModRM(3, 4, RAX);               // shl rax, imm8
+            emit8(instruction.modShift);
+            emitRegReg(0x01, dst, RAX);                      // add dst, rax
+            break;
+        case RandomXInstructionType::IADD_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, false, 0x03, dst);           // add dst, [rsi + rax]
+            break;
+        case RandomXInstructionType::ISUB_R:
+            emitRegReg(0x29, dst, src);                      // sub dst, src
+            break;
+        case RandomXInstructionType::ISUB_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, false, 0x2B, dst);           // sub dst, [rsi + rax]
+            break;
+        case RandomXInstructionType::IMUL_R:
+            emitRex(true, dst, 0, src);                      // imul dst, src
+            emit8(0x0F); emit8(0xAF); emitModRM(3, dst, src);
+            break;
+        case RandomXInstructionType::IMUL_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, true, 0xAF, dst);            // imul dst, [rsi + rax]
+            break;
+        case RandomXInstructionType::IMULH_R:
+        case RandomXInstructionType::ISMULH_R:
+            // RandomXVM::smulh is defined as the unsigned high product, so both use mul
+            emitRegReg(0x89, RAX, dst);                      // mov rax, dst
+            emitRex(true, 0, 0, src);
+            emit8(0xF7); emitModRM(3, 4, src);               // mul src
+            emitRegReg(0x89, dst, RDX);                      // mov dst, rdx
+            break;
+        case RandomXInstructionType::IMULH_M:
+        case RandomXInstructionType::ISMULH_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, false, 0x8B, RCX);           // mov rcx, [rsi + rax]
+            emitRegReg(0x89, RAX, dst);                      // mov rax, dst
+            emitRex(true, 0, 0, RCX);
+            emit8(0xF7); emitModRM(3, 4, RCX);               // mul rcx
+            emitRegReg(0x89, dst, RDX);                      // mov dst, rdx
+            break;
+        case RandomXInstructionType::IMUL_RCP:
+            if (instruction.imm32 != 0) {
+                emit8(0x48); emit8(0xB8);                    // mov rax, imm64
+                emit64(0xFFFFFFFFFFFFFFFFULL / instruction.imm32);
+                emitRex(true, dst, 0, RAX);                  // imul dst, rax
+                emit8(0x0F); emit8(0xAF); emitModRM(3, dst, RAX);
+            }
+            break;
+        case RandomXInstructionType::INEG_R:
+            emitRex(true, 0, 0, dst);
+            emit8(0xF7); emitModRM(3, 3, dst);               // neg dst
+            break;
+        case RandomXInstructionType::IXOR_R:
+            emitRegReg(0x31, dst, src);                      // xor dst, src
+            break;
+        case RandomXInstructionType::IXOR_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, false, 0x33, dst);           // xor dst, [rsi + rax]
+            break;
+        case RandomXInstructionType::IROR_R:
+        case RandomXInstructionType::IROL_R:
+            emitRegReg(0x89, RCX, src);                      // mov rcx, src
+            emitRex(true, 0, 0, dst);
+            emit8(0xD3);                                     // ror/rol dst, cl
+            emitModRM(3, instruction.type == RandomXInstructionType::IROR_R ? 1 : 0, dst);
+            break;
+        case RandomXInstructionType::ISWAP_R:
+            if (dst != src) {
+                emitRegReg(0x87, dst, src);                  // xchg dst, src
+            }
+            break;
+        case RandomXInstructionType::FSWAP_R:
+            if (fdst != fsrc) {
+                emitSse(0x66, 0x28, XMM_TEMP, fdst);         // movapd xmm8, fdst
+                emitSse(0x66, 0x28, fdst, fsrc);             // movapd fdst, fsrc
+                emitSse(0x66, 0x28, fsrc, XMM_TEMP);         // movapd fsrc, xmm8
+            }
+            break;
+        case RandomXInstructionType::FADD_R:
+            emitSse(0x66, 0x58, fdst, fsrc);                 // addpd
+            break;
+        case RandomXInstructionType::FADD_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0xF3, false, true, 0xE6, XMM_TEMP);   // cvtdq2pd xmm8, qword [rsi + rax]
+            emitSse(0x66, 0x58, fdst, XMM_TEMP);
+            break;
+        case RandomXInstructionType::FSUB_R:
+            emitSse(0x66, 0x5C, fdst, fsrc);                 // subpd
+            break;
+        case RandomXInstructionType::FSUB_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0xF3, false, true, 0xE6, XMM_TEMP);
+            emitSse(0x66, 0x5C, fdst, XMM_TEMP);
+            break;
+        case RandomXInstructionType::FSCAL_R:
+            emit8(0x48); emit8(0xB8);                        // mov rax, sign bit
+            emit64(0x8000000000000000ULL);
+            emit8(0x66); emitRex(true, XMM_TEMP, 0, RAX);    // movq xmm8, rax
+            emit8(0x0F); emit8(0x6E); emitModRM(3, XMM_TEMP, RAX);
+            emitSse(0x66, 0x6C, XMM_TEMP, XMM_TEMP);         // punpcklqdq xmm8, xmm8
+            emitSse(0x66, 0x57, fdst, XMM_TEMP);             // xorpd fdst, xmm8
+            break;
+        case RandomXInstructionType::FMUL_R:
+            emitSse(0x66, 0x59, fdst, fsrc);                 // mulpd
+            break;
+        case RandomXInstructionType::FDIV_M:
+            emitLoadAddress(instruction);
+            emitRegMem(0, true, false, 0x8B, RCX);           // mov rcx, [rsi + rax]
+            emit8(0x48); emit8(0x83); emit8(0xC9); emit8(0x01);              // or rcx, 1
+            emit8(0x48); emit8(0x0F); emit8(0xBA); emit8(0xE9); emit8(32);   // bts rcx, 32
+            emit8(0x66); emitRex(true, XMM_TEMP, 0, RCX);    // movq xmm8, rcx
+            emit8(0x0F); emit8(0x6E); emitModRM(3, XMM_TEMP, RCX);
+            emitSse(0xF3, 0xE6, XMM_TEMP, XMM_TEMP);         // cvtdq2pd xmm8, xmm8
+            emitSse(0x66, 0x5E, fdst, XMM_TEMP);             // divpd fdst, xmm8
+            break;
+        case RandomXInstructionType::FSQRT_R:
+            emitSse(0x66, 0x51, fdst, fdst);                 // sqrtpd
+            break;
+        case RandomXInstructionType::CBRANCH:
+            emit8(0x81); emitModRM(3, 0, RBX);               // add ebx, imm32
+            emit32(instruction.imm32);
+            emit8(0x81); emitModRM(3, 4, RBX);               // and ebx, imm32
+            emit32(instruction.modMask);
+            break;
+        case RandomXInstructionType::ISTORE:
+            emitAddress(dst, instruction.imm32, RandomXVM::tierMask(instruction.tier));
+            emitRegMem(0, true, false, 0x89, src);           // mov [rsi + rax], src
+            break;
+        case RandomXInstructionType::CFROUND: {
+            emitRegReg(0x89, RAX, src);                      // mov rax, src
+            emitRex(true, 0, 0, RAX);
+            emit8(0xC1); emitModRM(3, 1, RAX);               // ror rax, imm8
+            emit8(instruction.imm32 & 63);
+            emit8(0x83); emit8(0xE0); emit8(0x03);           // and eax, 3
+            emit8(0x3B); emitModRM(1, RAX, RDI);             // cmp eax, [rdi + roundingMode]
+            emit8(offsetof(RandomXJitState, roundingMode));
+            emit8(0x74);                                     // je skip (mode unchanged)
+            uint8_t* patch = m_cursor;
+            emit8(0);
+            emit8(0x89); emitModRM(1, RAX, RDI);             // mov [rdi + roundingMode], eax
+            emit8(offsetof(RandomXJitState, roundingMode));
+            emit8(0x8B); emitModRM(1, RCX, RDI);             // mov ecx, [rdi + mxcsr]
+            emit8(offsetof(RandomXJitState, mxcsr));
+            emit8(0x81); emitModRM(3, 4, RCX);               // and ecx, ~rounding control
+            emit32(~0x6000u);
+            emit8(0xC1); emitModRM(3, 4, RAX); emit8(13);    // shl eax, 13
+            emit8(0x09); emitModRM(3, RAX, RCX);             // or ecx, eax
+            emit8(0x89); emitModRM(1, RCX, RDI);             // mov [rdi + mxcsr], ecx
+            emit8(offsetof(RandomXJitState, mxcsr));
+            emit8(0x0F); emit8(0xAE); emitModRM(1, 2, RDI);  // ldmxcsr [rdi + mxcsr]
+            emit8(offsetof(RandomXJitState, mxcsr));
+            *patch = static_cast<uint8_t>(m_cursor - patch - 1);
+            break;
+        }
+        case RandomXInstructionType::NOP:
+            break;
+    }
+}
+
+#else
+
+// No JIT backend for this architecture or ABI; RandomXVM falls back to the threaded engine
+
+RandomXJitCompiler::RandomXJitCompiler()
+    : m_writeView(nullptr), m_execView(nullptr), m_capacity(0), m_codeSize(0),
+      m_dualMapped(false), m_compiled(false), m_cursor(nullptr) {
+}
+
+RandomXJitCompiler::~RandomXJitCompiler() = default;
+
+bool RandomXJitCompiler::isSupported() {
+    return false;
+}
+
+bool RandomXJitCompiler::initialize() {
+    return false;
+}
+
+void RandomXJitCompiler::destroy() {
+}
+
+bool RandomXJitCompiler::compile(const RandomXInstruction* program, size_t count,
+                                 const RandomXPrefetchHint* hints, size_t hintCount) {
+    return false;
+}
+
+void RandomXJitCompiler::run(RandomXJitState* state) const {
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include "share_queue.h"
+
+ShareQueue::ShareQueue() : m_head(nullptr), m_tail(nullptr), m_signal(0), m_closed(false) {
+    Node* stub = new Node();
+    m_head.store(stub, std::memory_order_relaxed);
+    m_tail = stub;
+}
+
+ShareQueue::~ShareQueue() {
+    while (pop()) {
+    }
+    delete m_tail;
+}
+
+void ShareQueue::push(std::unique_ptr<FoundShare> share) {
+    Node* node = new Node();
+    node->share = std::move(share);
+    
+    // Until prev->next is stored the consumer just sees an empty queue
+    Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    m_signal.notify_one();
+}
+
+std::unique_ptr<FoundShare> ShareQueue::pop() {
+    Node* tail = m_tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        return nullptr;
+    }
+    
+    // next becomes the consumed placeholder
+    m_tail = next;
+    std::unique_ptr<FoundShare> share = std::move(next->share);
+    delete tail;
+    return share;
+}
+
+void ShareQueue::wait() {
+    // A push after this load changes m_signal, so the wait cannot miss it
+    uint32_t observed = m_signal.load(std::memory_order_seq_cst);
+    if (m_closed.load(std::memory_order_seq_cst) || m_tail->next.load(std::memory_order_acquire)) {
+        return;
+    }
+    m_signal.wait(observed, std::memory_order_seq_cst);
+}
+
+void ShareQueue::close() {
+    // Flag first, so a consumer that loads m_signal after the bump sees it
+    m_closed.store(true, std::memory_order_seq_cst);
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    m_signal.notify_all();
+}
+
+void ShareQueue::open() {
+    m_closed.store(false, std::memory_order_seq_cst);
+}
+
+bool ShareQueue::isClosed() const {
+    return m_closed.load(std::memory_order_seq_cst);
+}
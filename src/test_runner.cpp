@@ -2,6 +2,15 @@
 #include "logger.h"
 #include "miner.h"
 #include "randomx.h"
+#include "randomx_jit.h"
+#include "randomx_aes.h"
+#include "randomx_blake2b.h"
+#include "randomx_argon2.h"
+#include "cpu_topology.h"
+#include "cpu_features.h"
+#include "thread_tuner.h"
+#include "nonce_allocator.h"
+#include "share_queue.h"
 #include "config_manager.h"
 #include "cli_manager.h"
 #include "memory_manager.h"
@@ -10,6 +19,14 @@
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <cstring>
+#include <cfenv>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
 
 /**
  * Comprehensive test runner for MiningSoft
@@ -76,6 +93,249 @@ public:
         std::cout << "  Max: " << randomxBench.maxTimeMs << "ms" << std::endl;
         std::cout << "  Std Dev: " << randomxBench.standardDeviation << "ms" << std::endl;
         std::cout << "  Iterations: " << randomxBench.iterations << std::endl;
+        
+        runRandomXScalingBenchmark();
+        runRandomXEngineBenchmark();
+        runRandomXProgramGenerationBenchmark();
+        runRandomXAesBenchmark();
+        runRandomXBlake2bBenchmark();
+        runRandomXBatchBenchmark();
+        runRandomXDatasetLatencyBenchmark();
+        runRandomXDatasetInitBenchmark();
+        runRandomXMemoryModeBenchmark();
+        runRandomXScratchpadBenchmark();
+        runRandomXHugePageBenchmark();
+        runRandomXCacheBenchmark();
+    }
+    
+    void runRandomXCacheBenchmark() {
+        // Light mode builds only the Argon2d cache: the cost paid again on every seed change
+        RandomXCache cache;
+        uint8_t key[32] = {0};
+        if (!cache.initialize(key, sizeof(key), true)) {
+            std::cout << "RandomX Cache Init: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        std::cout << "RandomX Cache Init: Argon2d " << RandomXArgon2::kernelToString(RandomXArgon2::activeKernel())
+                  << " kernel, " << RANDOMX_ARGON_LANES << " lanes, " << cache.getCacheSeconds() << " s for "
+                  << RANDOMX_CACHE_SIZE / (1024 * 1024) << " MB" << std::endl;
+    }
+    
+    void runRandomXHugePageBenchmark() {
+        // Dependent random reads over 256 MiB: the gap between the two runs is the dTLB cost
+        RandomXPages standardPages;
+        RandomXPages hugePages;
+        double standardLatency = RandomX::benchmarkPageLatency(false, standardPages);
+        double hugeLatency = RandomX::benchmarkPageLatency(true, hugePages);
+        
+        std::cout << "RandomX Huge Pages (" << RandomXMemory::hugePageStatus() << "):" << std::endl;
+        std::cout << "  standard pages: " << standardLatency << " ns/read" << std::endl;
+        std::cout << "  " << RandomXMemory::pagesToString(hugePages) << " pages: " << hugeLatency << " ns/read" << std::endl;
+    }
+    
+    void runRandomXScratchpadBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        if (!randomx.initialize(key, sizeof(key), false, 1)) {
+            std::cout << "RandomX Scratchpad: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        // Dependent reads within each tier show where a thread's working set sits
+        std::cout << "RandomX Scratchpad (per thread):" << std::endl;
+        const std::pair<const char*, size_t> tiers[] = {
+            {"L1", RANDOMX_SCRATCHPAD_L1_SIZE}, {"L2", RANDOMX_SCRATCHPAD_L2_SIZE}, {"L3", RANDOMX_SCRATCHPAD_SIZE}};
+        for (const auto& [name, bytes] : tiers) {
+            RandomXPages pages;
+            double nsPerRead = RandomX::benchmarkPageLatency(false, pages, bytes);
+            std::cout << "  " << name << " tier (" << bytes / 1024 << " KB): " << nsPerRead << " ns/read" << std::endl;
+        }
+        
+        double hashRate = randomx.benchmark(500);
+        std::cout << "  " << (hashRate > 0.0 ? 1000000.0 / hashRate : 0.0) << " us/hash, "
+                  << randomx.getBatchSize() * RANDOMX_SCRATCHPAD_SIZE / 1024 << " KB scratchpad, "
+                  << RANDOMX_SCRATCHPAD_L2_SIZE / 1024 << " KB of it L2-resident" << std::endl;
+    }
+    
+    void runRandomXMemoryModeBenchmark() {
+        uint8_t key[32] = {0};
+        std::cout << "RandomX Memory Modes:" << std::endl;
+        
+        for (MemoryMode mode : {MemoryMode::LIGHT, MemoryMode::FAST}) {
+            size_t residentBefore = MemoryUtils::getProcessResidentMemory();
+            RandomX randomx;
+            if (!randomx.initialize(key, sizeof(key), mode, 1)) {
+                std::cout << "  " << RandomX::memoryModeToString(mode) << ": skipped (initialization failed)" << std::endl;
+                continue;
+            }
+            size_t residentAfter = MemoryUtils::getProcessResidentMemory();
+            
+            double hashRate = randomx.benchmark(2000);
+            double residentMB = residentAfter > residentBefore
+                ? static_cast<double>(residentAfter - residentBefore) / (1024 * 1024) : 0.0;
+            std::cout << "  " << RandomX::memoryModeToString(mode) << ": " << hashRate << " H/s, +"
+                      << residentMB << " MB RSS" << std::endl;
+        }
+    }
+    
+    void runRandomXDatasetInitBenchmark() {
+        uint8_t key[32] = {0};
+        int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        
+        // Powers of two up to N, plus N itself
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2) {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(maxThreads);
+        
+        std::cout << "RandomX Dataset Init (startup time):" << std::endl;
+        double singleThread = 0.0;
+        for (int threads : threadCounts) {
+            RandomXCache cache;
+            if (!cache.initialize(key, sizeof(key), false, threads)) {
+                std::cout << "  " << threads << " thread(s): skipped (initialization failed)" << std::endl;
+                continue;
+            }
+            
+            double seconds = cache.getInitSeconds();
+            if (threads == 1) {
+                singleThread = seconds;
+            }
+            double speedup = seconds > 0.0 ? singleThread / seconds : 0.0;
+            std::cout << "  " << threads << " thread(s): " << seconds << " s ("
+                      << speedup << "x), Argon2d cache " << cache.getCacheSeconds() << " s" << std::endl;
+        }
+    }
+    
+    void runRandomXDatasetLatencyBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        if (!randomx.initialize(key, sizeof(key), false, 1)) {
+            std::cout << "RandomX Dataset Latency: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        // One item per program, prefetched when the program starts as the VM does
+        std::cout << "RandomX Dataset Latency (per program):" << std::endl;
+        double cold = randomx.benchmarkDatasetLatency(false);
+        double prefetched = randomx.benchmarkDatasetLatency(true);
+        double speedup = prefetched > 0.0 ? cold / prefetched : 0.0;
+        std::cout << "  no prefetch: " << cold << " ns" << std::endl;
+        std::cout << "  prefetch at program start: " << prefetched << " ns (" << speedup << "x)" << std::endl;
+    }
+    
+    void runRandomXBatchBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        randomx.setBatchSize(RANDOMX_MAX_BATCH_SIZE);
+        if (!randomx.initialize(key, sizeof(key), false, 1)) {
+            std::cout << "RandomX Batch Width: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        std::cout << "RandomX Batch Width (" << RandomX::engineToString(randomx.getEngine()) << " engine):" << std::endl;
+        double singleLane = 0.0;
+        for (size_t batchSize = 1; batchSize <= RANDOMX_MAX_BATCH_SIZE; ++batchSize) {
+            double hashRate = randomx.benchmarkBatch(batchSize, 2000);
+            if (batchSize == 1) {
+                singleLane = hashRate;
+            }
+            double speedup = singleLane > 0.0 ? hashRate / singleLane : 0.0;
+            std::cout << "  " << batchSize << " lane(s): " << hashRate << " H/s ("
+                      << speedup << "x)" << std::endl;
+        }
+    }
+    
+    void runRandomXProgramGenerationBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        if (!randomx.initialize(key, sizeof(key), false, 1)) {
+            std::cout << "RandomX Program Generation: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        // Generation is paid once per hash, next to one execution of the program
+        double generateNs = randomx.benchmarkProgramGeneration();
+        double executeNs = randomx.benchmarkEngine(randomx.getEngine(), 2000) * RANDOMX_PROGRAM_SIZE;
+        double share = generateNs + executeNs > 0.0 ? generateNs / (generateNs + executeNs) * 100.0 : 0.0;
+        std::cout << "RandomX Program Generation:" << std::endl;
+        std::cout << "  generate: " << generateNs << " ns/program" << std::endl;
+        std::cout << "  execute (" << RandomX::engineToString(randomx.getEngine()) << "): "
+                  << executeNs << " ns/program (generation " << share << "% of both)" << std::endl;
+    }
+    
+    void runRandomXAesBenchmark() {
+        // One scratchpad-sized buffer, so the figure is the kernel rather than DRAM
+        std::cout << "RandomX AES Kernels (active: " << RandomXAes::kernelToString(RandomXAes::activeKernel())
+                  << "):" << std::endl;
+        for (RandomXAesKernel kernel : RandomXAes::supportedKernels()) {
+            double gbPerSecond = RandomXAes::benchmark(kernel, RANDOMX_SCRATCHPAD_SIZE, 200);
+            std::cout << "  " << RandomXAes::kernelToString(kernel) << ": " << gbPerSecond << " GB/s" << std::endl;
+        }
+    }
+    
+    void runRandomXBlake2bBenchmark() {
+        // Per nonce: one seed digest of the input and one final digest of 72 bytes of state plus the input
+        double cyclesPerNs = RandomXBlake2b::cyclesPerNanosecond();
+        std::cout << "RandomX Blake2b (active: " << RandomXBlake2b::kernelToString(RandomXBlake2b::activeKernel())
+                  << "):" << std::endl;
+        for (RandomXBlake2bKernel kernel : RandomXBlake2b::supportedKernels()) {
+            for (size_t size : {size_t(76), size_t(148), size_t(64 * 1024)}) {
+                uint32_t iterations = static_cast<uint32_t>(std::max<size_t>(1000, 64 * 1024 * 1024 / size / 4));
+                double nsPerByte = RandomXBlake2b::benchmark(kernel, size, iterations);
+                std::cout << "  " << RandomXBlake2b::kernelToString(kernel) << " " << size << " B: "
+                          << nsPerByte << " ns/byte";
+                if (cyclesPerNs > 0.0) {
+                    std::cout << " (" << nsPerByte * cyclesPerNs << " cycles/byte)";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    
+    void runRandomXEngineBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        if (!randomx.initialize(key, sizeof(key), false, 1)) {
+            std::cout << "RandomX Execution Engines: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        std::cout << "RandomX Execution Engines:" << std::endl;
+        std::vector<RandomXEngine> engines = {RandomXEngine::INTERPRETER, RandomXEngine::THREADED};
+        if (RandomXJitCompiler::isSupported()) {
+            engines.push_back(RandomXEngine::JIT);
+        }
+        
+        for (RandomXEngine engine : engines) {
+            double nsPerInstruction = randomx.benchmarkEngine(engine, 2000);
+            std::cout << "  " << RandomX::engineToString(engine) << ": "
+                      << nsPerInstruction << " ns/instruction" << std::endl;
+        }
+    }
+    
+    void runRandomXScalingBenchmark() {
+        RandomX randomx;
+        uint8_t key[32] = {0};
+        int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        if (!randomx.initialize(key, sizeof(key), false, maxThreads)) {
+            std::cout << "RandomX Thread Scaling: skipped (initialization failed)" << std::endl;
+            return;
+        }
+        
+        std::cout << "RandomX Thread Scaling:" << std::endl;
+        double singleThread = 0.0;
+        for (int threads = 1; threads <= maxThreads; ++threads) {
+            double hashRate = randomx.benchmarkThreads(threads, 2000);
+            if (threads == 1) {
+                singleThread = hashRate;
+            }
+            double efficiency = singleThread > 0.0 ? hashRate / (singleThread * threads) * 100.0 : 0.0;
+            std::cout << "  " << threads << " thread(s): " << hashRate << " H/s ("
+                      << efficiency << "% of linear)" << std::endl;
+        }
     }
 
 private:
@@ -148,6 +408,729 @@ std::vector<TestResult> RandomXTestSuite::runTests() {
         }
     }(), "", std::chrono::milliseconds(0), "RandomX"));
     
+    results.push_back(TestResult("RandomX Per-Worker Hashing", []() -> bool {
+        try {
+            RandomX randomx;
+            uint8_t key[32] = {0};
+            if (!randomx.initialize(key, sizeof(key), false, 2)) return false;
+            
+            // Two threads hashing concurrently must match a single-threaded reference
+            uint8_t input[32] = {0x42};
+            uint8_t reference[32];
+            randomx.calculateHash(input, sizeof(input), reference);
+            
+            uint8_t outputs[2][32];
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 2; ++t) {
+                threads.emplace_back([&randomx, &input, &outputs, t]() {
+                    int workerId = randomx.acquireWorker();
+                    for (int i = 0; i < 100; ++i) {
+                        randomx.calculateHash(workerId, input, sizeof(input), outputs[t]);
+                    }
+                    randomx.releaseWorker(workerId);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            
+            return std::memcmp(outputs[0], reference, 32) == 0 &&
+                   std::memcmp(outputs[1], reference, 32) == 0;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Threaded Engine Matches Interpreter", []() -> bool {
+        try {
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key))) return false;
+            
+            RandomXVM interpreter;
+            RandomXVM threaded;
+            interpreter.initialize(&cache);
+            threaded.initialize(&cache);
+            interpreter.setEngine(RandomXEngine::INTERPRETER);
+            threaded.setEngine(RandomXEngine::THREADED);
+            
+            for (int program = 0; program < 500; ++program) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                interpreter.reset();
+                threaded.reset();
+                interpreter.loadProgram(input.data(), input.size());
+                threaded.loadProgram(input.data(), input.size());
+                interpreter.execute();
+                threaded.execute();
+                
+                for (int i = 0; i < 8; ++i) {
+                    double a[2] = {interpreter.getFloatRegister(i, 0), interpreter.getFloatRegister(i, 1)};
+                    double b[2] = {threaded.getFloatRegister(i, 0), threaded.getFloatRegister(i, 1)};
+                    if (interpreter.getRegister(i) != threaded.getRegister(i) ||
+                        interpreter.getScratchpad(i) != threaded.getScratchpad(i) ||
+                        std::memcmp(a, b, sizeof(a)) != 0) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX JIT Matches Interpreter", []() -> bool {
+        try {
+            if (!RandomXJitCompiler::isSupported()) return true;
+            
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key))) return false;
+            
+            RandomXVM interpreter;
+            RandomXVM jit;
+            interpreter.initialize(&cache);
+            jit.initialize(&cache);
+            interpreter.setEngine(RandomXEngine::INTERPRETER);
+            jit.setEngine(RandomXEngine::JIT);
+            
+            std::mt19937_64 rng(0x52616e646f6d58ULL);
+            for (int program = 0; program < 500; ++program) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                interpreter.reset();
+                jit.reset();
+                for (int i = 0; i < 8; ++i) {
+                    uint64_t value = rng();
+                    interpreter.setRegister(i, value);
+                    jit.setRegister(i, value);
+                }
+                interpreter.loadProgram(input.data(), input.size());
+                jit.loadProgram(input.data(), input.size());
+                
+                // Several passes so memory operands see non-trivial addresses
+                for (int pass = 0; pass < 3; ++pass) {
+                    interpreter.execute();
+                    jit.execute();
+                }
+                
+                for (int i = 0; i < 8; ++i) {
+                    double a[2] = {interpreter.getFloatRegister(i, 0), interpreter.getFloatRegister(i, 1)};
+                    double b[2] = {jit.getFloatRegister(i, 0), jit.getFloatRegister(i, 1)};
+                    if (interpreter.getRegister(i) != jit.getRegister(i) ||
+                        interpreter.getScratchpad(i) != jit.getScratchpad(i) ||
+                        std::memcmp(a, b, sizeof(a)) != 0) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX CFROUND Restores Rounding Mode", []() -> bool {
+        try {
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key))) return false;
+            
+            const RandomXEngine engines[] = {RandomXEngine::INTERPRETER, RandomXEngine::THREADED, RandomXEngine::JIT};
+            RandomXVM vms[3];
+            for (int i = 0; i < 3; ++i) {
+                vms[i].initialize(&cache);
+                vms[i].setEngine(engines[i]);
+            }
+            RandomXVM lanes[2];
+            for (auto& lane : lanes) {
+                lane.initialize(&cache);
+                lane.setEngine(RandomXEngine::THREADED);
+            }
+            
+            // Programs switch modes mid-run; every engine must hand back round-to-nearest
+            int cfrounds = 0;
+            for (int program = 0; program < 100; ++program) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                for (auto& vm : vms) {
+                    vm.reset();
+                    vm.loadProgram(input.data(), input.size());
+                    vm.execute();
+                    if (std::fegetround() != FE_TONEAREST) return false;
+                }
+                for (int i = 0; i < RANDOMX_PROGRAM_SIZE; ++i) {
+                    cfrounds += vms[0].getInstruction(i).type == RandomXInstructionType::CFROUND;
+                }
+                
+                RandomXVM* batch[2] = {&lanes[0], &lanes[1]};
+                for (auto* lane : batch) {
+                    lane->reset();
+                    lane->loadProgram(input.data(), input.size());
+                }
+                RandomXVM::executeLockstep(batch, 2);
+                if (std::fegetround() != FE_TONEAREST) return false;
+                
+                for (int i = 0; i < 8; ++i) {
+                    double a[2] = {vms[0].getFloatRegister(i, 0), vms[0].getFloatRegister(i, 1)};
+                    double b[2] = {lanes[1].getFloatRegister(i, 0), lanes[1].getFloatRegister(i, 1)};
+                    if (std::memcmp(a, b, sizeof(a)) != 0) return false;
+                }
+            }
+            return cfrounds > 0;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Program Generation", []() -> bool {
+        try {
+            RandomXVM a;
+            RandomXVM b;
+            a.initialize(nullptr);
+            b.initialize(nullptr);
+            
+            // Same seed gives the same program; one changed nonce byte changes it
+            std::vector<uint8_t> seed = TestFramework::generateRandomBytes(76);
+            a.generateProgram(seed.data(), seed.size());
+            b.generateProgram(seed.data(), seed.size());
+            bool changed = false;
+            for (int pc = 0; pc < static_cast<int>(RANDOMX_PROGRAM_SIZE); ++pc) {
+                const RandomXInstruction& x = a.getInstruction(pc);
+                const RandomXInstruction& y = b.getInstruction(pc);
+                if (x.type != y.type || x.imm64 != y.imm64) return false;
+                if (static_cast<int>(x.type) >= 30 || x.dst > 7 || x.src > 7 || x.mod > 7 ||
+                    x.modShift < 1 || x.modShift > 8) {
+                    return false;
+                }
+            }
+            seed[39] ^= 1;
+            b.generateProgram(seed.data(), seed.size());
+            for (int pc = 0; pc < static_cast<int>(RANDOMX_PROGRAM_SIZE); ++pc) {
+                changed = changed || a.getInstruction(pc).imm64 != b.getInstruction(pc).imm64;
+            }
+            return changed;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Dispatched Kernels", []() -> bool {
+        try {
+            if (CpuFeatures::featureString().empty()) return false;
+            
+            // Hex codec against an iostream reference, across the vector/tail boundary
+            for (size_t length = 0; length < 80; ++length) {
+                std::vector<uint8_t> bytes = TestFramework::generateRandomBytes(length);
+                std::ostringstream reference;
+                reference << std::hex << std::setfill('0');
+                for (uint8_t byte : bytes) {
+                    reference << std::setw(2) << static_cast<int>(byte);
+                }
+                std::string hex = RandomX::bytesToHex(bytes.data(), bytes.size());
+                if (hex != reference.str() || RandomX::hexToBytes(hex) != bytes) return false;
+            }
+            if (RandomX::hexToBytes("0A1bzz3") != std::vector<uint8_t>{0x0a, 0x1b}) return false;
+            
+            // Grouped dataset kernel against the single-item reference
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key), true)) return false;
+            RandomXDatasetItem items[18];
+            cache.computeDatasetItems(1000, 18, items);
+            for (uint32_t i = 0; i < 18; ++i) {
+                RandomXDatasetItem expected;
+                cache.computeDatasetItem(1000 + i, expected);
+                if (std::memcmp(&expected, &items[i], sizeof(expected)) != 0) return false;
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX AES Kernels", []() -> bool {
+        try {
+            // AESENC example from Intel's AES-NI white paper (bytes listed high to low)
+            auto parse = [](const char* hex, uint8_t* bytes) {
+                for (int i = 0; i < 16; ++i) {
+                    bytes[15 - i] = static_cast<uint8_t>(std::stoi(std::string(hex + 2 * i, 2), nullptr, 16));
+                }
+            };
+            uint8_t input[16], key[16], expected[16];
+            parse("7b5b54657374566563746f725d53475d", input);
+            parse("48692853686179295b477565726f6e5d", key);
+            parse("a8311c2f9fdba3c58b104b58ded7e595", expected);
+            
+            // Every kernel must produce the same known stream
+            std::vector<uint8_t> buffer(64 * 1024);
+            for (RandomXAesKernel kernel : RandomXAes::supportedKernels()) {
+                uint8_t output[16];
+                RandomXAes::encryptRound(kernel, input, key, output);
+                if (std::memcmp(output, expected, sizeof(output)) != 0) return false;
+                
+                alignas(64) uint8_t state[RANDOMX_AES_STATE_SIZE];
+                for (size_t i = 0; i < sizeof(state); ++i) {
+                    state[i] = static_cast<uint8_t>(i);
+                }
+                RandomXAes::fill(kernel, state, buffer.data(), buffer.size());
+                uint64_t digest = 0xcbf29ce484222325ULL;
+                for (uint8_t byte : buffer) {
+                    digest = (digest ^ byte) * 0x100000001b3ULL;
+                }
+                if (digest != 0xe30f1bba5ad33f38ULL) return false;
+                if (std::memcmp(state, buffer.data() + buffer.size() - sizeof(state), sizeof(state)) != 0) return false;
+            }
+            return RandomXAes::isSupported(RandomXAes::activeKernel());
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Blake2b Test Vectors", []() -> bool {
+        try {
+            struct Vector {
+                std::vector<uint8_t> message;
+                size_t digestSize;
+                const char* expected;
+            };
+            std::vector<uint8_t> counting(256);
+            for (size_t i = 0; i < counting.size(); ++i) {
+                counting[i] = static_cast<uint8_t>(i);
+            }
+            std::vector<uint8_t> longMessage;
+            for (int i = 0; i < 5; ++i) {
+                longMessage.insert(longMessage.end(), counting.begin(), counting.end());
+            }
+            
+            // RFC 7693 "abc", the empty message, and exact and multi-block lengths
+            const std::vector<Vector> vectors = {
+                {{'a', 'b', 'c'}, 64, "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+                                      "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923"},
+                {{}, 64, "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419"
+                         "d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce"},
+                {{'a', 'b', 'c'}, 32, "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319"},
+                {std::vector<uint8_t>(counting.begin(), counting.begin() + 128), 64,
+                 "2319e3789c47e2daa5fe807f61bec2a1a6537fa03f19ff32e87eecbfd64b7e0e"
+                 "8ccff439ac333b040f19b0c4ddd11a61e24ac1fe0f10a039806c5dcc0da3d115"},
+                {counting, 32, "39a7eb9fedc19aabc83425c6755dd90e6f9d0c804964a1f4aaeea3b9fb599835"},
+                {longMessage, 64, "a86b784c748f990b998e6d30d71e20cc95228d2b08dd85e29f63e4de8d8839bd"
+                                  "f935f4291537af5014fe44c0b578a073e4c9217c7b05542d0c450784c30bac8a"}
+            };
+            
+            for (RandomXBlake2bKernel kernel : RandomXBlake2b::supportedKernels()) {
+                for (const Vector& vector : vectors) {
+                    // Whole message at once, then in 7-byte pieces across block boundaries
+                    for (size_t piece : {vector.message.size() + 1, size_t(7)}) {
+                        RandomXBlake2bState state;
+                        if (!RandomXBlake2b::init(state, vector.digestSize, kernel)) return false;
+                        for (size_t offset = 0; offset < vector.message.size(); offset += piece) {
+                            RandomXBlake2b::update(state, vector.message.data() + offset,
+                                                   std::min(piece, vector.message.size() - offset));
+                        }
+                        uint8_t digest[RANDOMX_BLAKE2B_MAX_DIGEST];
+                        RandomXBlake2b::final(state, digest);
+                        
+                        std::ostringstream hex;
+                        for (size_t i = 0; i < vector.digestSize; ++i) {
+                            hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+                        }
+                        if (hex.str() != vector.expected) return false;
+                    }
+                }
+            }
+            
+            RandomXBlake2bState state;
+            return !RandomXBlake2b::init(state, 0) && !RandomXBlake2b::init(state, 65);
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Argon2d", []() -> bool {
+        try {
+            // RFC 9106 section 5.1 test vector
+            std::vector<uint8_t> password(32, 0x01), salt(16, 0x02), secret(8, 0x03), data(12, 0x04);
+            RandomXArgon2Params params;
+            params.memoryKiB = 32;
+            params.passes = 3;
+            params.lanes = 4;
+            params.tagSize = 32;
+            params.password = password.data();
+            params.passwordSize = password.size();
+            params.salt = salt.data();
+            params.saltSize = salt.size();
+            params.secret = secret.data();
+            params.secretSize = secret.size();
+            params.associatedData = data.data();
+            params.associatedDataSize = data.size();
+            const uint8_t expected[32] = {
+                0x51, 0x2b, 0x39, 0x1b, 0x6f, 0x11, 0x62, 0x97, 0x53, 0x71, 0xd3, 0x09, 0x19, 0x73, 0x42, 0x94,
+                0xf8, 0x68, 0xe3, 0xbe, 0x39, 0x84, 0xf3, 0xc1, 0xa1, 0x3a, 0x4d, 0xb9, 0xfa, 0xbe, 0x4a, 0xcb
+            };
+            for (RandomXArgon2Kernel kernel : RandomXArgon2::supportedKernels()) {
+                uint8_t tag[32];
+                if (!RandomXArgon2::hash(tag, params, kernel) || std::memcmp(tag, expected, sizeof(tag)) != 0) {
+                    return false;
+                }
+            }
+            
+            // Lanes filled by one thread or one thread each give the same memory
+            params.memoryKiB = 1024;
+            params.lanes = RANDOMX_ARGON_LANES;
+            size_t size = RandomXArgon2::blockCount(params) * RANDOMX_ARGON2_BLOCK_SIZE;
+            std::unique_ptr<uint8_t, decltype(&std::free)> single(static_cast<uint8_t*>(std::aligned_alloc(64, size)), &std::free);
+            std::unique_ptr<uint8_t, decltype(&std::free)> parallel(static_cast<uint8_t*>(std::aligned_alloc(64, size)), &std::free);
+            if (!RandomXArgon2::fillMemory(single.get(), params, 1) ||
+                !RandomXArgon2::fillMemory(parallel.get(), params, RANDOMX_ARGON_LANES)) {
+                return false;
+            }
+            return std::memcmp(single.get(), parallel.get(), size) == 0;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Scratchpad Matches Across Engines", []() -> bool {
+        try {
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key))) return false;
+            
+            std::vector<RandomXEngine> engines = {RandomXEngine::INTERPRETER, RandomXEngine::THREADED};
+            if (RandomXJitCompiler::isSupported()) {
+                engines.push_back(RandomXEngine::JIT);
+            }
+            std::vector<std::unique_ptr<RandomXVM>> vms;
+            for (size_t i = 0; i < engines.size() + 2; ++i) {
+                vms.push_back(std::make_unique<RandomXVM>());
+                vms.back()->initialize(&cache);
+                vms.back()->setEngine(i < engines.size() ? engines[i] : RandomXEngine::THREADED);
+            }
+            
+            // Stores land in all three tiers, so compare every byte, including a lockstep pair
+            for (int program = 0; program < 100; ++program) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                for (auto& vm : vms) {
+                    vm->reset();
+                    vm->loadProgram(input.data(), input.size());
+                }
+                for (size_t i = 0; i < engines.size(); ++i) {
+                    vms[i]->execute();
+                }
+                RandomXVM* pair[2] = {vms[engines.size()].get(), vms[engines.size() + 1].get()};
+                RandomXVM::executeLockstep(pair, 2);
+                
+                for (size_t i = 1; i < vms.size(); ++i) {
+                    if (std::memcmp(vms[0]->getScratchpadData(), vms[i]->getScratchpadData(), RANDOMX_SCRATCHPAD_SIZE) != 0) {
+                        return false;
+                    }
+                    for (int r = 0; r < 8; ++r) {
+                        if (vms[0]->getRegister(r) != vms[i]->getRegister(r)) return false;
+                    }
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Batch Matches Single Hash", []() -> bool {
+        try {
+            RandomX randomx;
+            uint8_t key[32] = {0};
+            randomx.setBatchSize(RANDOMX_MAX_BATCH_SIZE);
+            if (!randomx.initialize(key, sizeof(key), false, 1)) return false;
+            
+            // Odd count so the final batch runs with fewer lanes
+            constexpr size_t count = 2 * RANDOMX_MAX_BATCH_SIZE + 1;
+            std::vector<uint8_t> inputs = TestFramework::generateRandomBytes(76 * count);
+            std::vector<uint8_t> outputs(RANDOMX_HASH_SIZE * count);
+            randomx.calculateHashBatch(0, inputs.data(), 76, count, outputs.data());
+            
+            for (size_t i = 0; i < count; ++i) {
+                uint8_t reference[RANDOMX_HASH_SIZE];
+                randomx.calculateHash(0, inputs.data() + i * 76, 76, reference);
+                if (std::memcmp(reference, outputs.data() + i * RANDOMX_HASH_SIZE, RANDOMX_HASH_SIZE) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Prefetch Preserves Results", []() -> bool {
+        try {
+            RandomXCache cache;
+            uint8_t key[32] = {0};
+            if (!cache.initialize(key, sizeof(key))) return false;
+            
+            RandomXVM reference;
+            reference.initialize(&cache);
+            reference.setEngine(RandomXEngine::INTERPRETER);
+            reference.setPrefetchDistance(0);
+            
+            std::vector<RandomXEngine> engines = {RandomXEngine::INTERPRETER, RandomXEngine::THREADED};
+            if (RandomXJitCompiler::isSupported()) {
+                engines.push_back(RandomXEngine::JIT);
+            }
+            
+            for (int program = 0; program < 200; ++program) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                reference.reset();
+                reference.loadProgram(input.data(), input.size());
+                reference.execute();
+                
+                for (RandomXEngine engine : engines) {
+                    RandomXVM vm;
+                    vm.initialize(&cache);
+                    vm.setEngine(engine);
+                    vm.setPrefetchDistance(RANDOMX_MAX_PREFETCH_DISTANCE);
+                    vm.loadProgram(input.data(), input.size());
+                    vm.execute();
+                    
+                    for (int i = 0; i < 8; ++i) {
+                        double a[2] = {reference.getFloatRegister(i, 0), reference.getFloatRegister(i, 1)};
+                        double b[2] = {vm.getFloatRegister(i, 0), vm.getFloatRegister(i, 1)};
+                        if (reference.getRegister(i) != vm.getRegister(i) ||
+                            reference.getScratchpad(i) != vm.getScratchpad(i) ||
+                            std::memcmp(a, b, sizeof(a)) != 0) {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Light Mode Matches Fast Mode", []() -> bool {
+        try {
+            uint8_t key[32] = {0};
+            RandomX fast;
+            RandomX light;
+            if (!fast.initialize(key, sizeof(key), MemoryMode::FAST, 1)) return false;
+            if (!light.initialize(key, sizeof(key), MemoryMode::LIGHT, 1)) return false;
+            if (light.getMemoryMode() != MemoryMode::LIGHT) return false;
+            
+            for (int i = 0; i < 100; ++i) {
+                std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+                uint8_t fastHash[RANDOMX_HASH_SIZE];
+                uint8_t lightHash[RANDOMX_HASH_SIZE];
+                fast.calculateHash(0, input.data(), input.size(), fastHash);
+                light.calculateHash(0, input.data(), input.size(), lightHash);
+                if (std::memcmp(fastHash, lightHash, RANDOMX_HASH_SIZE) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Key Change Matches Fresh Initialize", []() -> bool {
+        try {
+            uint8_t oldKey[32] = {0};
+            uint8_t newKey[32];
+            for (int i = 0; i < 32; ++i) newKey[i] = static_cast<uint8_t>(i + 1);
+            
+            RandomX switched;
+            RandomX fresh;
+            if (!switched.initialize(oldKey, sizeof(oldKey), MemoryMode::LIGHT, 1)) return false;
+            if (!fresh.initialize(newKey, sizeof(newKey), MemoryMode::LIGHT, 1)) return false;
+            
+            std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+            uint8_t before[RANDOMX_HASH_SIZE];
+            uint8_t during[RANDOMX_HASH_SIZE];
+            uint8_t after[RANDOMX_HASH_SIZE];
+            uint8_t expected[RANDOMX_HASH_SIZE];
+            
+            // Hashing keeps using the old key while the next one builds
+            switched.calculateHash(0, input.data(), input.size(), before);
+            if (!switched.prepareNextKey(newKey, sizeof(newKey))) return false;
+            switched.calculateHash(0, input.data(), input.size(), during);
+            while (!switched.isNextKeyReady()) {
+                if (!switched.isNextKeyBuilding()) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            if (!switched.activateNextKey()) return false;
+            
+            switched.calculateHash(0, input.data(), input.size(), after);
+            fresh.calculateHash(0, input.data(), input.size(), expected);
+            return std::memcmp(before, during, RANDOMX_HASH_SIZE) == 0 &&
+                   std::memcmp(after, expected, RANDOMX_HASH_SIZE) == 0 &&
+                   std::memcmp(before, after, RANDOMX_HASH_SIZE) != 0;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Variants", []() -> bool {
+        try {
+            RandomXVariant parsed;
+            if (!RandomX::variantFromString("rx/wow", parsed) || parsed != RandomXVariant::RX_WOW) return false;
+            if (!RandomX::variantFromString("randomx", parsed) || parsed != RandomXVariant::RX_0) return false;
+            if (RandomX::variantFromString("cn/r", parsed)) return false;
+            
+            uint8_t key[32] = {0};
+            std::vector<uint8_t> input = TestFramework::generateRandomBytes(76);
+            for (RandomXVariant variant : {RandomXVariant::RX_WOW, RandomXVariant::RX_ARQ}) {
+                RandomXCache cache;
+                cache.setVariant(variant);
+                if (!cache.initialize(key, sizeof(key), true)) return false;
+                
+                // Engines agree within the variant's tiers and never touch the rest
+                RandomXVM interpreter;
+                RandomXVM threaded;
+                interpreter.initialize(&cache);
+                threaded.initialize(&cache);
+                interpreter.setEngine(RandomXEngine::INTERPRETER);
+                const size_t words = threaded.getScratchpadSize() / 8;
+                for (RandomXVM* vm : {&interpreter, &threaded}) {
+                    vm->setScratchpad(static_cast<int>(words), 0x5555555555555555ULL);
+                    vm->reset();
+                    vm->loadProgram(input.data(), input.size());
+                    vm->execute();
+                    if (vm->getScratchpad(static_cast<int>(words)) != 0x5555555555555555ULL) return false;
+                }
+                if (std::memcmp(interpreter.getScratchpadData(), threaded.getScratchpadData(), words * 8) != 0) {
+                    return false;
+                }
+                for (int r = 0; r < 8; ++r) {
+                    if (interpreter.getRegister(r) != threaded.getRegister(r)) return false;
+                }
+            }
+            
+            // Switching variant with the key changes the hash
+            RandomX randomx;
+            if (!randomx.initialize(key, sizeof(key), MemoryMode::LIGHT, 1)) return false;
+            uint8_t rx0[RANDOMX_HASH_SIZE];
+            uint8_t wow[RANDOMX_HASH_SIZE];
+            randomx.calculateHash(0, input.data(), input.size(), rx0);
+            if (!randomx.prepareNextKey(key, sizeof(key), RandomXVariant::RX_WOW)) return false;
+            while (!randomx.isNextKeyReady()) {
+                if (!randomx.isNextKeyBuilding()) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            if (!randomx.activateNextKey()) return false;
+            randomx.calculateHash(0, input.data(), input.size(), wow);
+            return randomx.getVariant() == RandomXVariant::RX_WOW &&
+                   std::memcmp(rx0, wow, RANDOMX_HASH_SIZE) != 0;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Dataset File Cache Round Trip", []() -> bool {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "miningsoft-dataset-test";
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+        try {
+            uint8_t key[32];
+            for (int i = 0; i < 32; ++i) key[i] = static_cast<uint8_t>(0xA0 + i);
+            
+            RandomXCache cold;
+            cold.setDatasetCacheDir(directory.string());
+            if (!cold.initialize(key, sizeof(key), false, 0) || cold.isDatasetFromFile()) return false;
+            
+            RandomXCache warm;
+            warm.setDatasetCacheDir(directory.string());
+            if (!warm.initialize(key, sizeof(key), false, 0) || !warm.isDatasetFromFile()) return false;
+            
+            bool match = true;
+            for (uint32_t index = 0; match && index < RANDOMX_DATASET_SIZE / 64; index += 4099) {
+                match = std::memcmp(cold.getDatasetItem(index), warm.getDatasetItem(index), sizeof(RandomXDatasetItem)) == 0;
+            }
+            
+            cold.destroy();
+            warm.destroy();
+            std::filesystem::remove_all(directory, error);
+            return match;
+        } catch (...) {
+            std::filesystem::remove_all(directory, error);
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX Large Page Allocation", []() -> bool {
+        try {
+            for (bool useHugePages : {false, true}) {
+                RandomXMemoryBlock block = RandomXMemory::allocate(3 * 1024 * 1024, useHugePages, "test buffer");
+                if (!block.memory || block.size < 3 * 1024 * 1024) return false;
+                if (reinterpret_cast<uintptr_t>(block.memory) % RANDOMX_DATASET_CHUNK_SIZE != 0) return false;
+                if (!useHugePages && block.pages != RandomXPages::STANDARD) return false;
+                
+                std::memset(block.memory, 0xA5, block.size);
+                bool intact = static_cast<uint8_t*>(block.memory)[block.size - 1] == 0xA5;
+                RandomXMemory::release(block);
+                if (!intact || block.memory) return false;
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("CPU List Parsing", []() -> bool {
+        std::vector<int> cpus = CpuTopology::parseCpuList("0-3,8,10-11\n");
+        std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+        return cpus == expected && CpuTopology::parseCpuList("").empty() && !CpuTopology::detectNumaNodes().empty();
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("RandomX NUMA Replicas Match", []() -> bool {
+        try {
+            // Two nodes sharing CPU 0 exercise replication on any machine
+            NumaNode node;
+            node.cpus = {0};
+            std::vector<NumaNode> nodes(2, node);
+            nodes[1].id = 1;
+            
+            uint8_t key[32] = {0};
+            RandomXCache cache;
+            cache.setNumaNodes(nodes);
+            if (!cache.initialize(key, sizeof(key), false, 0) || cache.getReplicaCount() != 2) return false;
+            if (cache.getDatasetItem(0, 0) == cache.getDatasetItem(0, 1)) return false;
+            
+            for (uint32_t index = 0; index < RANDOMX_DATASET_SIZE / 64; index += 4099) {
+                RandomXDatasetItem expected;
+                cache.computeDatasetItem(index, expected);
+                if (std::memcmp(cache.getDatasetItem(index, 0), &expected, sizeof(expected)) != 0 ||
+                    std::memcmp(cache.getDatasetItem(index, 1), &expected, sizeof(expected)) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
+    results.push_back(TestResult("Thread Tuner Plan", []() -> bool {
+        ThreadPlan plan = ThreadTuner::propose();
+        if (plan.threads < 1 || static_cast<unsigned int>(plan.threads) > std::max(1u, std::thread::hardware_concurrency())) {
+            return false;
+        }
+        std::vector<int> unique = plan.cpus;
+        std::sort(unique.begin(), unique.end());
+        if (!plan.cpus.empty() && (static_cast<int>(plan.cpus.size()) != plan.threads ||
+                                   std::unique(unique.begin(), unique.end()) != unique.end())) {
+            return false;
+        }
+        
+        // A stored plan only comes back for the same fingerprint
+        std::string path = (std::filesystem::temp_directory_path() / "randomx-tuning-test.json").string();
+        ThreadPlan loaded;
+        bool roundTrip = ThreadTuner::save(path, "host-a", plan) && ThreadTuner::load(path, "host-a", loaded) &&
+                         loaded.threads == plan.threads && loaded.cpus == plan.cpus &&
+                         !ThreadTuner::load(path, "host-b", loaded);
+        std::filesystem::remove(path);
+        return roundTrip && CpuTopology::formatCpuList({0, 1, 2, 3, 8, 10, 11}) == "0-3,8,10-11";
+    }(), "", std::chrono::milliseconds(0), "RandomX"));
+    
     results.push_back(TestResult("RandomX Hash Calculation", []() -> bool {
         try {
             RandomX randomx;
@@ -191,6 +1174,132 @@ std::vector<TestResult> MinerTestSuite::runTests() {
         }
     }(), "", std::chrono::milliseconds(0), "Miner"));
     
+    results.push_back(TestResult("Mining Job Decoding", []() -> bool {
+        try {
+            MiningJob job;
+            std::vector<uint8_t> blob = TestFramework::generateRandomBytes(76);
+            job.blob = RandomX::bytesToHex(blob.data(), blob.size());
+            job.target = "b88d0600";
+            if (!Miner::decodeJob(job)) return false;
+            if (job.blobSize != 76 || std::memcmp(job.blobBytes.data(), blob.data(), 76) != 0) return false;
+            if (job.target64 != 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / 0x00068db8ULL)) return false;
+            
+            // Only the hash's top 8 bytes (little-endian) are compared
+            uint8_t hash[32] = {0};
+            hash[31] = 0x00;
+            hash[30] = 0x06;
+            if (!Miner::meetsTarget(hash, job.target64)) return false;
+            hash[30] = 0x07;
+            if (Miner::meetsTarget(hash, job.target64)) return false;
+            
+            // Full 32-byte targets and malformed input
+            job.target = std::string(48, '0') + "ffffffffffffff00";
+            if (!Miner::decodeJob(job) || job.target64 != 0x00ffffffffffffffULL) return false;
+            job.blob = "zz";
+            return !Miner::decodeJob(job);
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Miner"));
+    
+    results.push_back(TestResult("Nonce Allocator Covers Job Once", []() -> bool {
+        try {
+            // Two reserved bytes keep the pool's 0x1234 prefix and leave 65536 nonces
+            NonceAllocator allocator(2, 0x1234ABCD);
+            std::vector<std::atomic<uint8_t>> seen(allocator.getCapacity());
+            std::atomic<bool> outside(false);
+            
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&allocator, &seen, &outside, t]() {
+                    NonceRange range;
+                    while (allocator.claim(NonceAllocator::chunkSize(100.0 * (t + 1), 2), range)) {
+                        for (uint32_t i = 0; i < range.count; ++i) {
+                            uint32_t nonce = range.first + i;
+                            if ((nonce >> 16) != 0x1234) {
+                                outside = true;
+                                return;
+                            }
+                            seen[nonce & 0xFFFF].fetch_add(1);
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            
+            if (outside || allocator.getClaimed() != allocator.getCapacity()) return false;
+            for (auto& count : seen) {
+                if (count.load() != 1) return false;
+            }
+            
+            // Four local instances split the bits below one reserved byte into quarters
+            NonceAllocator slice(1, 0x7F000055, 4, 3);
+            NonceRange first;
+            if (slice.getCapacity() != (1u << 22) || !slice.claim(16, first) ||
+                first.first != (0x7F000000u | (3u << 22))) return false;
+            
+            return NonceAllocator::chunkSize(0.0, 4) == 4 && NonceAllocator::chunkSize(1000.0, 4) == 500 &&
+                   NonceAllocator::chunkSize(1e9, 4) == NONCE_MAX_CHUNK;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Miner"));
+    
+    results.push_back(TestResult("Share Queue Delivers Every Share Once", []() -> bool {
+        try {
+            // Four mining threads push while the submission thread drains
+            constexpr uint32_t perProducer = 20000;
+            ShareQueue queue;
+            std::vector<std::thread> producers;
+            for (uint32_t t = 0; t < 4; ++t) {
+                producers.emplace_back([&queue, t]() {
+                    for (uint32_t i = 0; i < perProducer; ++i) {
+                        auto share = std::make_unique<FoundShare>();
+                        share->jobId = std::to_string(t);
+                        share->nonce = (t << 24) | i;
+                        queue.push(std::move(share));
+                    }
+                });
+            }
+            
+            std::vector<uint32_t> next(4, 0);
+            bool ordered = true;
+            std::thread consumer([&queue, &next, &ordered]() {
+                while (true) {
+                    std::unique_ptr<FoundShare> share = queue.pop();
+                    if (share) {
+                        // Shares from one thread arrive in the order it found them
+                        uint32_t t = share->nonce >> 24;
+                        if (t > 3 || share->jobId != std::to_string(t) || (share->nonce & 0xFFFFFF) != next[t]) {
+                            ordered = false;
+                        }
+                        next[t < 4 ? t : 0]++;
+                    } else if (queue.isClosed()) {
+                        break;
+                    } else {
+                        queue.wait();
+                    }
+                }
+            });
+            
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            queue.close();
+            consumer.join();
+            
+            if (!ordered || queue.pop()) return false;
+            for (uint32_t count : next) {
+                if (count != perProducer) return false;
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Miner"));
+    
     return results;
 }
 
@@ -247,6 +1356,47 @@ std::vector<TestResult> PerformanceTestSuite::runTests() {
         }
     }(), "", std::chrono::milliseconds(0), "Performance"));
     
+    results.push_back(TestResult("Performance Monitor Job Switch Latency", []() -> bool {
+        try {
+            PerformanceMonitor perf;
+            perf.recordJobSwitch(4.0);
+            perf.recordJobSwitch(2.0);
+            return perf.getJobSwitches() == 2 && perf.getLastJobSwitchMs() == 2.0 &&
+                   perf.getAverageJobSwitchMs() == 3.0 && perf.getMaxJobSwitchMs() == 4.0 &&
+                   perf.exportStats().find("\"jobSwitch\"") != std::string::npos;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Performance"));
+    
+    results.push_back(TestResult("Performance Monitor Counts Stale Shares Apart", []() -> bool {
+        try {
+            PerformanceMonitor perf;
+            perf.updateShares(10, 9, 1, 5);
+            return perf.getSharesStale() == 5 && perf.getSharesRejected() == 1 &&
+                   perf.getAcceptanceRate() == 90.0 &&
+                   perf.exportStats().find("\"stale\": 5") != std::string::npos;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Performance"));
+    
+    results.push_back(TestResult("Performance Monitor Share Latency Histogram", []() -> bool {
+        try {
+            PerformanceMonitor perf;
+            for (double milliseconds : {0.5, 3.0, 3.0, 100.0}) {
+                perf.recordShareLatency(milliseconds);
+            }
+            const LatencyHistogram& latency = perf.getShareLatency();
+            return latency.getCount() == 4 && latency.getBucket(0) == 1 && latency.getBucket(2) == 2 &&
+                   latency.getBucket(7) == 1 && latency.getAverageMs() == 26.625 &&
+                   latency.getPercentileMs(0.5) == 4.0 && latency.getPercentileMs(0.99) == 128.0 &&
+                   perf.exportStats().find("\"shareLatency\"") != std::string::npos;
+        } catch (...) {
+            return false;
+        }
+    }(), "", std::chrono::milliseconds(0), "Performance"));
+    
     return results;
 }
 
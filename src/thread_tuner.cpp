@@ -0,0 +1,196 @@
+#include "thread_tuner.h"
+#include "cpu_topology.h"
+#include "randomx.h"
+#include "simple_json.h"
+#include "logger.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+
+// The cache instance of a level that serves a CPU (nullptr if unknown)
+static const CpuCache* cacheOf(const std::vector<CpuCache>& caches, int cpu) {
+    for (const auto& cache : caches) {
+        if (std::find(cache.cpus.begin(), cache.cpus.end(), cpu) != cache.cpus.end()) {
+            return &cache;
+        }
+    }
+    return nullptr;
+}
+
+ThreadPlan ThreadTuner::propose() {
+    ThreadPlan plan;
+    std::vector<CpuCore> cores = CpuTopology::detectCores();
+    std::vector<CpuCache> l2 = CpuTopology::detectCaches(2);
+    std::vector<CpuCache> l3 = CpuTopology::detectCaches(3);
+    
+    // Remaining scratchpads each cache can hold; caches without a size do not limit
+    auto l3Budget = [&l3](int cpu) -> size_t {
+        const CpuCache* cache = cacheOf(l3, cpu);
+        return cache ? cache->sizeBytes / RANDOMX_SCRATCHPAD_SIZE : SIZE_MAX;
+    };
+    auto l2Budget = [&l2](int cpu) -> size_t {
+        const CpuCache* cache = cacheOf(l2, cpu);
+        return cache ? cache->sizeBytes / RANDOMX_SCRATCHPAD_L2_SIZE : SIZE_MAX;
+    };
+    std::vector<size_t> l3Used(l3.size(), 0);
+    std::vector<size_t> l2Used(l2.size(), 0);
+    
+    auto tryTake = [&](int cpu) {
+        const CpuCache* shared3 = cacheOf(l3, cpu);
+        const CpuCache* shared2 = cacheOf(l2, cpu);
+        size_t* used3 = shared3 ? &l3Used[shared3 - l3.data()] : nullptr;
+        size_t* used2 = shared2 ? &l2Used[shared2 - l2.data()] : nullptr;
+        if ((used3 && *used3 >= std::max<size_t>(1, l3Budget(cpu))) ||
+            (used2 && *used2 >= std::max<size_t>(1, l2Budget(cpu)))) {
+            return false;
+        }
+        if (used3) (*used3)++;
+        if (used2) (*used2)++;
+        plan.cpus.push_back(cpu);
+        return true;
+    };
+    
+    // First one thread per physical core, then SMT siblings where the caches allow
+    size_t siblings = 0;
+    for (const auto& core : cores) {
+        tryTake(core.threads.front());
+    }
+    for (const auto& core : cores) {
+        for (size_t t = 1; t < core.threads.size(); t++) {
+            siblings += tryTake(core.threads[t]) ? 1 : 0;
+        }
+    }
+    
+    if (plan.cpus.empty()) {
+        plan.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        plan.reason = "no topology information";
+        return plan;
+    }
+    
+    // Worker order follows the CPU order so NUMA blocks and cache domains line up
+    std::sort(plan.cpus.begin(), plan.cpus.end());
+    plan.threads = static_cast<int>(plan.cpus.size());
+    
+    std::ostringstream reason;
+    reason << plan.threads - siblings << " of " << cores.size() << " cores";
+    if (siblings > 0) {
+        reason << " + " << siblings << " SMT siblings";
+    }
+    if (!l3.empty()) {
+        reason << ", " << l3.size() << " L3 of " << l3.front().sizeBytes / (1024 * 1024) << " MB";
+    }
+    plan.reason = reason.str();
+    return plan;
+}
+
+ThreadPlan ThreadTuner::calibrate(RandomX& randomx, const ThreadPlan& proposal, uint32_t iterationsPerThread) {
+    std::vector<ThreadPlan> candidates = {proposal};
+    
+    ThreadPlan physical;
+    physical.reason = "all physical cores";
+    ThreadPlan logical;
+    logical.reason = "all hardware threads";
+    for (const auto& core : CpuTopology::detectCores()) {
+        physical.cpus.push_back(core.threads.front());
+        logical.cpus.insert(logical.cpus.end(), core.threads.begin(), core.threads.end());
+    }
+    for (ThreadPlan* candidate : {&physical, &logical}) {
+        std::sort(candidate->cpus.begin(), candidate->cpus.end());
+        candidate->threads = static_cast<int>(candidate->cpus.size());
+        bool duplicate = std::any_of(candidates.begin(), candidates.end(), [candidate](const ThreadPlan& other) {
+            return other.threads == candidate->threads;
+        });
+        if (!duplicate && candidate->threads > 0) {
+            candidates.push_back(*candidate);
+        }
+    }
+    
+    ThreadPlan best;
+    for (auto& candidate : candidates) {
+        if (candidate.threads > randomx.getWorkerCount()) {
+            continue;
+        }
+        
+        randomx.setWorkerCpus(candidate.cpus);
+        candidate.hashRate = randomx.benchmarkThreads(candidate.threads, iterationsPerThread);
+        std::ostringstream hashRate;
+        hashRate << std::fixed << std::setprecision(2) << candidate.hashRate;
+        LOG_INFO("Thread calibration: {} threads ({}) -> {} H/s", candidate.threads, candidate.reason,
+                 hashRate.str());
+        
+        // More threads must beat the current choice by more than measurement noise
+        if (best.threads == 0 || candidate.hashRate > best.hashRate * 1.02) {
+            best = candidate;
+        }
+    }
+    
+    if (best.threads == 0) {
+        best = proposal;
+    }
+    randomx.setWorkerCpus(best.cpus);
+    return best;
+}
+
+std::string ThreadTuner::fingerprint(const RandomX& randomx) {
+    std::vector<CpuCore> cores = CpuTopology::detectCores();
+    size_t logical = 0;
+    for (const auto& core : cores) {
+        logical += core.threads.size();
+    }
+    
+    std::ostringstream key;
+    key << "cpus=" << logical << ";cores=" << cores.size();
+    for (int level : {2, 3}) {
+        std::vector<CpuCache> caches = CpuTopology::detectCaches(level);
+        key << ";l" << level << "=" << caches.size() << "x" << (caches.empty() ? 0 : caches.front().sizeBytes);
+    }
+    key << ";engine=" << RandomX::engineToString(randomx.getEngine())
+        << ";batch=" << randomx.getBatchSize()
+        << ";mode=" << RandomX::memoryModeToString(randomx.getMemoryMode())
+        << ";nodes=" << randomx.getNumaNodeCount();
+    return key.str();
+}
+
+bool ThreadTuner::load(const std::string& path, const std::string& fingerprint, ThreadPlan& plan) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    SimpleJSON json;
+    if (!json.parse(buffer.str())) {
+        LOG_WARNING("Ignoring unreadable thread tuning file {}", path);
+        return false;
+    }
+    
+    if (json.getString("tuning.fingerprint") != fingerprint) {
+        LOG_INFO("Stored thread tuning in {} is for different hardware or settings, recalibrating", path);
+        return false;
+    }
+    
+    plan.threads = json.getInt("tuning.threads", 0);
+    plan.cpus = CpuTopology::parseCpuList(json.getString("tuning.cpus"));
+    plan.hashRate = json.getDouble("tuning.hashRate", 0.0);
+    plan.reason = "stored in " + path;
+    return plan.threads > 0 && (plan.cpus.empty() || static_cast<int>(plan.cpus.size()) == plan.threads);
+}
+
+bool ThreadTuner::save(const std::string& path, const std::string& fingerprint, const ThreadPlan& plan) {
+    std::ofstream file(path);
+    if (!file) {
+        LOG_WARNING("Failed to write thread tuning file {}", path);
+        return false;
+    }
+    
+    file << "{\n";
+    file << "  \"tuning.fingerprint\": \"" << fingerprint << "\",\n";
+    file << "  \"tuning.threads\": " << plan.threads << ",\n";
+    file << "  \"tuning.cpus\": \"" << CpuTopology::formatCpuList(plan.cpus) << "\",\n";
+    file << "  \"tuning.hashRate\": " << plan.hashRate << "\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}